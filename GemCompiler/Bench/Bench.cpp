@@ -0,0 +1,82 @@
+#include "Bench.h"
+
+#include <algorithm>
+#include <iomanip>
+
+#include "Token/Simd.h"
+
+namespace GC::Bench {
+
+    double Result::best() const {
+        return samples.empty() ? 0.0 : *std::min_element(samples.begin(), samples.end());
+    }
+
+    double Result::median() const {
+        if (samples.empty())
+            return 0.0;
+        std::vector<double> sorted = samples;
+        std::sort(sorted.begin(), sorted.end());
+        return sorted[sorted.size() / 2];
+    }
+
+    namespace {
+
+        double Rate(size_t amount, double seconds) {
+            return seconds > 0.0 ? static_cast<double>(amount) / seconds : 0.0;
+        }
+
+        void ReportText(std::ostream& os, const std::vector<Result>& results) {
+            os << std::left << std::setw(26) << "benchmark"
+               << std::right << std::setw(12) << "median ms"
+               << std::setw(12) << "MB/s"
+               << std::setw(16) << "M items/s" << "\n";
+            for (const Result& result : results) {
+                double median = result.median();
+                os << std::left << std::setw(26) << result.name
+                   << std::right << std::fixed << std::setprecision(3)
+                   << std::setw(12) << median * 1e3
+                   << std::setprecision(1);
+                if (result.bytes)
+                    os << std::setw(12) << Rate(result.bytes, median) / 1e6;
+                else
+                    os << std::setw(12) << "-";
+                os << std::setw(10) << Rate(result.items, median) / 1e6
+                   << " " << result.itemUnit << "\n";
+            }
+            os << "(simd: " << Simd::IsaName(Simd::DetectIsa()) << ")\n";
+        }
+
+        void ReportJson(std::ostream& os, const std::vector<Result>& results) {
+            os << "{\n  \"simd\": \"" << Simd::IsaName(Simd::DetectIsa()) << "\",\n  \"benchmarks\": [";
+            for (size_t i = 0; i < results.size(); i++) {
+                const Result& result = results[i];
+                double median = result.median();
+                os << (i ? "," : "") << "\n    { \"name\": \"" << result.name << "\""
+                   << ", \"bytes\": " << result.bytes
+                   << ", \"items\": " << result.items
+                   << ", \"item_unit\": \"" << result.itemUnit << "\""
+                   << ", \"repetitions\": " << result.samples.size()
+                   << std::setprecision(9)
+                   << ", \"best_s\": " << result.best()
+                   << ", \"median_s\": " << median
+                   << ", \"mb_per_s\": ";
+                if (result.bytes)
+                    os << Rate(result.bytes, median) / 1e6;
+                else
+                    os << "null";
+                os << ", \"items_per_s\": " << Rate(result.items, median)
+                   << " }";
+            }
+            os << "\n  ]\n}\n";
+        }
+
+    } // namespace
+
+    void Report(std::ostream& os, const std::vector<Result>& results, bool json) {
+        if (json)
+            ReportJson(os, results);
+        else
+            ReportText(os, results);
+    }
+
+} // namespace GC::Bench
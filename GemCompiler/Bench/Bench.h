@@ -0,0 +1,77 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace GC::Bench {
+
+    //------------------------------------------------------------------------------
+    // 1. Options (set from the command line, see main.cpp)
+    //------------------------------------------------------------------------------
+    struct Options {
+        size_t corpusBytes = 16u << 20;
+        uint32_t seed = 1;
+        int warmup = 2;
+        int repetitions = 10;
+        bool json = false;
+    };
+
+    //------------------------------------------------------------------------------
+    // 2. Results
+    //------------------------------------------------------------------------------
+    struct Result {
+        std::string name;
+        size_t bytes = 0;               // Input bytes per repetition (0 if not meaningful).
+        size_t items = 0;               // Tokens, identifiers, ... per repetition.
+        std::string itemUnit;
+        std::vector<double> samples;    // Seconds per repetition.
+
+        double best() const;
+        double median() const;
+    };
+
+    // Prints a human-readable table, or a JSON document when `json` is set.
+    void Report(std::ostream& os, const std::vector<Result>& results, bool json);
+
+    //------------------------------------------------------------------------------
+    // 3. Timing helpers
+    //------------------------------------------------------------------------------
+    template<typename Fn>
+    double TimeSeconds(Fn&& body) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double>(end - start).count();
+    }
+
+    // Runs `body` options.warmup times untimed, then options.repetitions timed.
+    template<typename Fn>
+    std::vector<double> Sample(const Options& options, Fn&& body) {
+        for (int i = 0; i < options.warmup; i++)
+            body();
+        std::vector<double> samples;
+        samples.reserve(options.repetitions);
+        for (int i = 0; i < options.repetitions; i++)
+            samples.push_back(TimeSeconds(body));
+        return samples;
+    }
+
+    //------------------------------------------------------------------------------
+    // 4. Benchmarks
+    //------------------------------------------------------------------------------
+    std::vector<Result> RunKeywordBench(const Options& options);
+    std::vector<Result> RunLexerBench(const Options& options);
+    std::vector<Result> RunParserBench(const Options& options);
+
+    //------------------------------------------------------------------------------
+    // 5. Checks (--check): return false and describe the first mismatch on `os`.
+    //------------------------------------------------------------------------------
+
+    // The parallel lexer's tokens and SymbolIds against the serial lexer's. Run
+    // it first in a fresh process: ids are only compared meaningfully while the
+    // global interner starts empty.
+    bool CheckParallelLexer(const Options& options, std::ostream& os);
+
+} // namespace GC::Bench
@@ -0,0 +1,284 @@
+#include "CorpusGenerator.h"
+
+#include <random>
+#include <string_view>
+
+namespace GC::Bench {
+
+    namespace {
+
+        class Generator {
+        public:
+            explicit Generator(uint32_t seed) : rng_(seed) {}
+
+            std::string run(size_t targetBytes) {
+                out_.reserve(targetBytes + 4096);
+                out_ += "|| ===================================================\n"
+                        "||  Generated benchmark corpus\n"
+                        "|| ===================================================\n"
+                        "import &\"file\"\n"
+                        "import &dependence { className }\n\n";
+                while (out_.size() < targetBytes) {
+                    switch (pick(8)) {
+                    case 0:  banner(); break;
+                    case 1:  blockComment(); break;
+                    case 2:  enumeration(); break;
+                    case 3:  classDefinition(); break;
+                    case 4:
+                    case 5:  function(); break;
+                    default: statements(0, 6); break;
+                    }
+                    out_ += "\n";
+                }
+                return std::move(out_);
+            }
+
+            // Embedded data: vec<str> tables of long string literals with occasional
+            // escapes, and char tables.
+            std::string runLiteralTable(size_t targetBytes) {
+                static const std::string_view escapes[] = { "\\n", "\\t", "\\\\", "\\\"", "\\0", "\\x41" };
+                static const std::string_view words[] = {
+                    "lorem", "ipsum", "dolor", "sit", "amet", "gem", "table", "entry", "payload", "data",
+                };
+                out_.reserve(targetBytes + 4096);
+                while (out_.size() < targetBytes) {
+                    bool chars = pick(4) == 0;
+                    out_ += chars ? "vec<u8> " : "vec<str> ";
+                    out_ += name() + " = [\n";
+                    for (size_t row = 0, rows = pick(32) + 8; row < rows; row++) {
+                        out_ += "    ";
+                        for (size_t col = 0; col < 8; col++) {
+                            if (chars) {
+                                out_ += pick(8) == 0 ? "'" + std::string(pick(escapes)) + "', " : std::string("'") + char('a' + pick(26)) + "', ";
+                                continue;
+                            }
+                            out_ += "\"";
+                            for (size_t w = 0, count = pick(12) + 2; w < count; w++) {
+                                out_ += pick(words);
+                                out_ += pick(10) == 0 ? pick(escapes) : " ";
+                            }
+                            out_ += "\", ";
+                        }
+                        out_ += "\n";
+                    }
+                    out_ += "]\n\n";
+                }
+                return std::move(out_);
+            }
+
+            // One assignment per line; every tenth is nested deeply.
+            std::string runExpressions(size_t targetBytes) {
+                out_.reserve(targetBytes + 4096);
+                while (out_.size() < targetBytes) {
+                    out_ += name() + " = ";
+                    if (pick(10) == 0) {
+                        size_t depth = pick(32) + 16;
+                        for (size_t i = 0; i < depth; i++)
+                            out_ += pick(4) == 0 ? "-(" : "(";
+                        out_ += name();
+                        for (size_t i = 0; i < depth; i++)
+                            out_ += " " + std::string(pick(chainOperators)) + " " + literal() + ")";
+                    }
+                    else {
+                        chain(pick(24) + 8);
+                    }
+                    out_ += "\n";
+                }
+                return std::move(out_);
+            }
+
+        private:
+            static constexpr std::string_view chainOperators[] = {
+                "+", "-", "*", "/", "%", "?+", "??", "<", "<=", ">", ">=", "==", "!=", "..",
+            };
+
+            // `terms` operands joined by operators of every tier.
+            void chain(size_t terms) {
+                for (size_t i = 0; i < terms; i++) {
+                    if (i)
+                        out_ += " " + std::string(pick(chainOperators)) + " ";
+                    switch (pick(6)) {
+                    case 0:  out_ += name() + "." + name(); break;
+                    case 1:  out_ += name() + "[" + name() + " + 1]"; break;
+                    case 2:  out_ += name() + "(" + name() + ", &@ " + name() + ")"; break;
+                    case 3:  out_ += "!" + name(); break;
+                    default: out_ += pick(2) ? name() : literal(); break;
+                    }
+                }
+            }
+
+            size_t pick(size_t n) { return std::uniform_int_distribution<size_t>(0, n - 1)(rng_); }
+
+            template<size_t N>
+            std::string_view pick(const std::string_view (&options)[N]) { return options[pick(N)]; }
+
+            std::string name() {
+                static const std::string_view stems[] = {
+                    "index", "value", "count", "item", "number", "total", "offset", "buffer",
+                    "result", "element", "width", "height", "cursor", "node", "entry", "limit",
+                };
+                std::string name(pick(stems));
+                if (pick(3) == 0)
+                    name += std::to_string(pick(100));
+                return name;
+            }
+
+            std::string typeName() {
+                static const std::string_view types[] = {
+                    "u8", "u16", "u32", "u64", "i8", "i16", "i32", "i64", "f32", "f64", "bool", "str",
+                };
+                return std::string(pick(types));
+            }
+
+            std::string literal() {
+                switch (pick(6)) {
+                case 0:  return std::to_string(pick(100)) + "." + std::to_string(pick(100));
+                case 1:  return "\"" + name() + " text\"";
+                case 2:  return "0x" + std::to_string(pick(9000) + 1000);
+                default: return std::to_string(pick(100000));
+                }
+            }
+
+            std::string expression(int depth = 0) {
+                static const std::string_view operators[] = { "+", "-", "*", "/", "%", "?+", "??", "<", ">=", "==" };
+                if (depth > 2 || pick(3) == 0)
+                    return pick(2) ? name() : literal();
+                switch (pick(4)) {
+                case 0:  return "( " + expression(depth + 1) + " )";
+                case 1:  return name() + "( " + expression(depth + 1) + ", &@ " + name() + " )";
+                default: return expression(depth + 1) + " " + std::string(pick(operators)) + " " + expression(depth + 1);
+                }
+            }
+
+            void indent(int depth) { out_.append(static_cast<size_t>(depth) * 4, ' '); }
+
+            void banner() {
+                out_ += "|| ===================================================\n"
+                        "||  Section " + name() + "\n"
+                        "|| ===================================================\n\n";
+            }
+
+            void blockComment() {
+                out_ += "|-- \nThis block comment documents " + name() + " and " + name() + ".\n"
+                        "It spans several lines, like the ones in doc.gem.\n--|\n";
+            }
+
+            void statements(int depth, size_t count) {
+                for (size_t i = 0; i < count; i++)
+                    statement(depth);
+            }
+
+            void statement(int depth) {
+                indent(depth);
+                switch (depth < 3 ? pick(8) : pick(3)) {
+                case 0:
+                    out_ += "|| Update " + name() + " before the next step.\n";
+                    break;
+                case 1:
+                    out_ += "@" + typeName() + " " + name() + " = " + expression() + "\n";
+                    break;
+                case 2:
+                    out_ += name() + " = " + expression() + "\n";
+                    break;
+                case 3:
+                    out_ += "iter ( " + std::to_string(pick(10)) + ".." + std::to_string(pick(100) + 10) + " | " + name() + " ) [\n";
+                    statements(depth + 1, pick(3) + 1);
+                    indent(depth);
+                    out_ += "]\n";
+                    break;
+                case 4:
+                    out_ += "while ( " + name() + " < " + literal() + " ) [\n";
+                    statements(depth + 1, pick(3) + 1);
+                    indent(depth);
+                    out_ += "]\n";
+                    break;
+                case 5:
+                    out_ += "if ( " + expression() + " ) [\n";
+                    statements(depth + 1, pick(3) + 1);
+                    indent(depth);
+                    out_ += "]\n";
+                    indent(depth);
+                    out_ += "else [\n";
+                    statements(depth + 1, 1);
+                    indent(depth);
+                    out_ += "]\n";
+                    break;
+                case 6:
+                    out_ += "compare ( " + expression() + " ) [\n";
+                    for (size_t i = 0, cases = pick(3) + 1; i < cases; i++) {
+                        indent(depth + 1);
+                        out_ += "on ( " + name() + " ) [\n";
+                        statements(depth + 2, 1);
+                        indent(depth + 1);
+                        out_ += "]\n";
+                    }
+                    indent(depth + 1);
+                    out_ += "default [\n";
+                    indent(depth + 1);
+                    out_ += "]\n";
+                    indent(depth);
+                    out_ += "]\n";
+                    break;
+                default:
+                    out_ += "vec<" + typeName() + "> " + name() + " = [\n";
+                    indent(depth + 1);
+                    out_ += literal() + ", " + literal() + ", " + literal() + "\n";
+                    indent(depth);
+                    out_ += "]\n";
+                    break;
+                }
+            }
+
+            void enumeration() {
+                out_ += "|| Enum " + name() + "\n";
+                if (pick(2))
+                    out_ += "enum #" + name() + "<T> ( T ) [\n";
+                else
+                    out_ += "enum " + name() + "( " + typeName() + " ) [\n";
+                size_t count = pick(5) + 2;
+                for (size_t i = 0; i < count; i++)
+                    out_ += "    " + name() + "(" + typeName() + ") = " + std::to_string(i) + (i + 1 < count ? ",\n" : "\n");
+                out_ += "]\n";
+            }
+
+            void function(int depth = 0) {
+                indent(depth);
+                out_ += "#" + name() + (pick(4) == 0 ? "<T>" : "") + " ( " + typeName() + " " + name() + ", " + typeName() + " " + name() + " ) -> " + typeName() + " [\n";
+                statements(depth + 1, pick(4) + 1);
+                indent(depth + 1);
+                out_ += "-> " + expression() + "\n";
+                indent(depth);
+                out_ += "]\n";
+            }
+
+            void classDefinition() {
+                std::string className = name();
+                out_ += "#" + className + (pick(3) == 0 ? "<T: GenericParam>" : "") + " [\n    public\n\n";
+                out_ += "        #" + className + " ( str name(name_), u32 age(age_) ) [\n        ]\n\n";
+                for (size_t i = 0, methods = pick(3) + 1; i < methods; i++)
+                    function(2);
+                out_ += "\n    private\n\n";
+                for (size_t i = 0, members = pick(4) + 1; i < members; i++)
+                    out_ += "        " + typeName() + " " + name() + "_\n";
+                out_ += "]\n";
+            }
+
+            std::mt19937 rng_;
+            std::string out_;
+        };
+
+    } // namespace
+
+    std::string GenerateCorpus(size_t targetBytes, uint32_t seed) {
+        return Generator(seed).run(targetBytes);
+    }
+
+    std::string GenerateLiteralTable(size_t targetBytes, uint32_t seed) {
+        return Generator(seed).runLiteralTable(targetBytes);
+    }
+
+    std::string GenerateExpressions(size_t targetBytes, uint32_t seed) {
+        return Generator(seed).runExpressions(targetBytes);
+    }
+
+} // namespace GC::Bench
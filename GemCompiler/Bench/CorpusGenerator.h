@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+namespace GC::Bench {
+
+    // Generates a synthetic .gem program of roughly `targetBytes` bytes, built from
+    // the constructs shown in GemFiles/doc.gem: comment banners and block comments,
+    // declarations, iter/while/if/compare, enums, classes, functions and generics.
+    // The same seed always yields the same program.
+    std::string GenerateCorpus(size_t targetBytes, uint32_t seed);
+
+    // Generates literal-heavy .gem source of roughly `targetBytes` bytes: embedded
+    // data tables of string literals (with escapes) and char literals.
+    std::string GenerateLiteralTable(size_t targetBytes, uint32_t seed);
+
+    // Generates expression-heavy .gem source of roughly `targetBytes` bytes:
+    // assignments of long operator chains mixing every precedence tier, calls,
+    // indexing and member access, nested up to a few dozen parentheses deep.
+    std::string GenerateExpressions(size_t targetBytes, uint32_t seed);
+
+} // namespace GC::Bench
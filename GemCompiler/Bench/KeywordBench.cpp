@@ -0,0 +1,102 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Bench.h"
+#include "Token/Keywords.h"
+
+namespace GC::Bench {
+
+    namespace {
+
+        //------------------------------------------------------------------------------
+        // Reference: the sequential if-chain the lexer used before the perfect hash.
+        //------------------------------------------------------------------------------
+        TokenType LookupKeywordChain(std::string_view ident) {
+            if (ident == "import")       return TokenType::Import;
+            if (ident == "iter")         return TokenType::Iter;
+            if (ident == "while")        return TokenType::While;
+            if (ident == "if")           return TokenType::If;
+            if (ident == "else")         return TokenType::Else;
+            if (ident == "enum")         return TokenType::Enum;
+            if (ident == "compare")      return TokenType::Compare;
+            if (ident == "on")           return TokenType::On;
+            if (ident == "default")      return TokenType::Default;
+            if (ident == "public")       return TokenType::Public;
+            if (ident == "private")      return TokenType::Private;
+            if (ident == "continue")     return TokenType::Continue;
+            if (ident == "break")        return TokenType::Break;
+            if (ident == "exitProgram")  return TokenType::ExitProgram;
+            if (ident == "vec")          return TokenType::Vec;
+            if (ident == "tuple")        return TokenType::Tuple;
+            if (ident == "destroy")      return TokenType::Destroy;
+            if (ident == "delete")       return TokenType::Delete;
+            if (ident == "u8")           return TokenType::U8;
+            if (ident == "u16")          return TokenType::U16;
+            if (ident == "u32")          return TokenType::U32;
+            if (ident == "u64")          return TokenType::U64;
+            if (ident == "i8")           return TokenType::I8;
+            if (ident == "i16")          return TokenType::I16;
+            if (ident == "i32")          return TokenType::I32;
+            if (ident == "i64")          return TokenType::I64;
+            if (ident == "f32")          return TokenType::F32;
+            if (ident == "f64")          return TokenType::F64;
+            if (ident == "bool")         return TokenType::Bool;
+            if (ident == "str")          return TokenType::Str;
+            return TokenType::Identifier;
+        }
+
+        //------------------------------------------------------------------------------
+        // Identifier-heavy corpus: ~85% plain identifiers, ~15% keywords.
+        //------------------------------------------------------------------------------
+        std::vector<std::string> MakeIdentifierCorpus(size_t count) {
+            static const char* stems[] = {
+                "index", "value", "count", "name_", "age_", "Id_", "item", "number",
+                "className", "functionName", "enumValue", "genericEnum", "apMut", "var_",
+                "a", "b", "i", "self", "isTrue", "constantNumber",
+            };
+            std::mt19937 rng(1234);
+            std::uniform_int_distribution<int> pick(0, 99);
+            std::vector<std::string> corpus;
+            corpus.reserve(count);
+            for (size_t i = 0; i < count; i++) {
+                int roll = pick(rng);
+                if (roll < 15)
+                    corpus.emplace_back(Keywords[roll % std::size(Keywords)].text);
+                else
+                    corpus.emplace_back(std::string(stems[roll % std::size(stems)]) + std::to_string(roll % 7));
+            }
+            return corpus;
+        }
+
+        template<typename Lookup>
+        Result Measure(const char* name, const std::vector<std::string>& corpus, const Options& options, Lookup lookup) {
+            // One sample covers several passes so that it runs long enough to time.
+            const int passes = 50;
+            size_t keywords = 0;
+            Result result{ name, 0, corpus.size() * passes, "identifiers", {} };
+            result.samples = Sample(options, [&] {
+                for (int pass = 0; pass < passes; pass++)
+                    for (const std::string& ident : corpus)
+                        keywords += lookup(ident) != TokenType::Identifier;
+            });
+            // Keep the lookups observable so they cannot be optimized away.
+            if (keywords == 0)
+                result.itemUnit += " (no keywords found)";
+            return result;
+        }
+
+    } // namespace
+
+    //------------------------------------------------------------------------------
+    // Keyword lookup: if-chain versus compile-time perfect hash.
+    //------------------------------------------------------------------------------
+    std::vector<Result> RunKeywordBench(const Options& options) {
+        const std::vector<std::string> corpus = MakeIdentifierCorpus(1 << 16);
+        return {
+            Measure("keywords/if-chain", corpus, options, LookupKeywordChain),
+            Measure("keywords/perfect-hash", corpus, options, [](std::string_view ident) { return LookupKeyword(ident); }),
+        };
+    }
+
+} // namespace GC::Bench
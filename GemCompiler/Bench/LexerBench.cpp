@@ -0,0 +1,110 @@
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "Bench.h"
+#include "CorpusGenerator.h"
+#include "Thread/ThreadPool.h"
+#include "Token/Simd.h"
+#include "Token/Token.h"
+#include "Token/TokenCache.h"
+
+namespace GC::Bench {
+
+    //------------------------------------------------------------------------------
+    // Lexer throughput on a generated corpus: batch, parallel and pull interfaces,
+    // a literal-heavy data table, a token cache hit, plus the batch lexer and the
+    // UTF-8 validator pinned to each SIMD tier the CPU supports.
+    //------------------------------------------------------------------------------
+    std::vector<Result> RunLexerBench(const Options& options) {
+        const std::string corpus = GenerateCorpus(options.corpusBytes, options.seed);
+        const size_t tokenCount = Tokenize(corpus).size();
+        std::vector<Result> results;
+
+        const auto measure = [&](std::string name, auto&& body) {
+            Result result{ std::move(name), corpus.size(), tokenCount, "tokens", {} };
+            result.samples = Sample(options, body);
+            results.push_back(std::move(result));
+        };
+
+        measure("tokenize", [&] { Tokenize(corpus); });
+
+        {
+            ThreadPool pool;
+            measure("tokenize/parallel-" + std::to_string(pool.size()), [&] { Tokenize(corpus, pool); });
+        }
+
+        measure("lexer/pull", [&] {
+            Lexer lexer(corpus);
+            while (lexer.next().getType() != TokenType::EndOfFile) {}
+        });
+
+        {
+            const std::string table = GenerateLiteralTable(options.corpusBytes, options.seed);
+            Result result{ "tokenize/literal-table", table.size(), Tokenize(table).size(), "tokens", {} };
+            result.samples = Sample(options, [&] { Tokenize(table); });
+            results.push_back(std::move(result));
+        }
+
+        {
+            const std::filesystem::path directory = std::filesystem::temp_directory_path() / "gem-bench-token-cache";
+            TokenCache cache(directory.string());
+            if (cache.store(corpus, Tokenize(corpus))) {
+                measure("token-cache/load", [&] {
+                    TokenStream tokens;
+                    cache.load(corpus, tokens);
+                });
+            }
+            std::error_code ec;
+            std::filesystem::remove_all(directory, ec);
+        }
+
+        const Simd::Isa detected = Simd::DetectIsa();
+        for (Simd::Isa isa : { Simd::Isa::Scalar, Simd::Isa::Sse2, Simd::Isa::Avx2 }) {
+            if (isa > detected)
+                break;
+            Simd::UseIsa(isa);
+            measure(std::string("tokenize/") + Simd::IsaName(isa), [&] { Tokenize(corpus); });
+            measure(std::string("validate-utf8/") + Simd::IsaName(isa), [&] {
+                Simd::ValidateUtf8(corpus.data(), corpus.data() + corpus.size());
+            });
+        }
+        Simd::UseIsa(detected);
+
+        return results;
+    }
+
+    //------------------------------------------------------------------------------
+    // The parallel lexer fills the global context; the serial one gets a context
+    // of its own, so both number the corpus's names from zero.
+    //------------------------------------------------------------------------------
+    bool CheckParallelLexer(const Options& options, std::ostream& os) {
+        const std::string corpus = GenerateCorpus(options.corpusBytes, options.seed);
+        if (CompilationContext::Global().interner().size() != 0) {
+            os << "check: the global interner is not empty; run the check in a fresh process\n";
+            return false;
+        }
+
+        // Enough workers for several chunks whatever the machine.
+        ThreadPool pool(8);
+        const TokenStream parallel = Tokenize(corpus, pool);
+        CompilationContext context;
+        const TokenStream serial = Lexer(corpus, context).tokenize();
+
+        if (parallel.size() != serial.size()) {
+            os << "check: " << parallel.size() << " parallel tokens, " << serial.size() << " serial\n";
+            return false;
+        }
+        for (size_t i = 0; i < serial.size(); i++) {
+            if (parallel.kind(i) != serial.kind(i) || parallel.offset(i) != serial.offset(i)
+                || parallel.length(i) != serial.length(i) || parallel.symbol(i) != serial.symbol(i)) {
+                os << "check: token " << i << " '" << serial.lexeme(i) << "' differs (SymbolId "
+                   << parallel.symbol(i) << " parallel, " << serial.symbol(i) << " serial)\n";
+                return false;
+            }
+        }
+        os << "check: parallel and serial lexers agree on " << serial.size() << " tokens\n";
+        return true;
+    }
+
+} // namespace GC::Bench
@@ -0,0 +1,53 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "Bench.h"
+#include "CorpusGenerator.h"
+#include "Parse/Parser.h"
+#include "Thread/ThreadPool.h"
+#include "Token/Token.h"
+
+namespace GC::Bench {
+
+    //------------------------------------------------------------------------------
+    // Parser throughput in source lines per second on a generated corpus: the
+    // parser alone over a token stream lexed up front, lexing plus parsing, the
+    // parser skipping function bodies, the parser alone on expression-heavy
+    // source, then top-level declarations parsed in parallel, one worker per
+    // hardware thread.
+    //------------------------------------------------------------------------------
+    std::vector<Result> RunParserBench(const Options& options) {
+        const std::string corpus = GenerateCorpus(options.corpusBytes, options.seed);
+        const size_t lineCount = static_cast<size_t>(std::count(corpus.begin(), corpus.end(), '\n'));
+        const TokenStream tokens = Tokenize(corpus);
+        std::vector<Result> results;
+
+        const auto measure = [&](std::string name, auto&& body) {
+            Result result{ std::move(name), corpus.size(), lineCount, "lines", {} };
+            result.samples = Sample(options, body);
+            results.push_back(std::move(result));
+        };
+
+        measure("parse", [&] { Parse(tokens); });
+        measure("tokenize+parse", [&] { Parse(Tokenize(corpus)); });
+        measure("parse/lazy-bodies", [&] { Parse(tokens, CompilationContext::Global(), BodyParsing::Lazy); });
+
+        {
+            const std::string expressions = GenerateExpressions(options.corpusBytes, options.seed);
+            const TokenStream expressionTokens = Tokenize(expressions);
+            Result result{ "parse/expressions", expressions.size(),
+                static_cast<size_t>(std::count(expressions.begin(), expressions.end(), '\n')), "lines", {} };
+            result.samples = Sample(options, [&] { Parse(expressionTokens); });
+            results.push_back(std::move(result));
+        }
+
+        {
+            ThreadPool pool;
+            measure("parse/parallel-" + std::to_string(pool.size()), [&] { Parse(tokens, pool); });
+        }
+
+        return results;
+    }
+
+} // namespace GC::Bench
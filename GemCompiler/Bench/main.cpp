@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "Bench.h"
+#include "CorpusGenerator.h"
+
+namespace {
+
+    void PrintUsage() {
+        std::cerr <<
+            "Usage: GemBench [options]\n"
+            "  --bench all|keywords|lexer|parser\n"
+            "                               Benchmarks to run (default: all)\n"
+            "  --size MB                    Generated corpus size (default: 16)\n"
+            "  --seed N                     Corpus generator seed (default: 1)\n"
+            "  --warmup N                   Untimed runs before measuring (default: 2)\n"
+            "  --reps N                     Timed repetitions (default: 10)\n"
+            "  --json                       Machine-readable output\n"
+            "  --emit-corpus PATH           Write the generated corpus and exit\n"
+            "  --check                      Check that the parallel lexer matches the serial one\n"
+            "                               and exit (run it on its own, in a fresh process)\n";
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    GC::Bench::Options options;
+    std::string bench = "all";
+    std::string corpusPath;
+    bool check = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--json")
+            options.json = true;
+        else if (arg == "--bench" && hasValue)
+            bench = argv[++i];
+        else if (arg == "--size" && hasValue)
+            options.corpusBytes = static_cast<size_t>(std::strtod(argv[++i], nullptr) * (1 << 20));
+        else if (arg == "--seed" && hasValue)
+            options.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--warmup" && hasValue)
+            options.warmup = std::atoi(argv[++i]);
+        else if (arg == "--reps" && hasValue)
+            options.repetitions = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--emit-corpus" && hasValue)
+            corpusPath = argv[++i];
+        else if (arg == "--check")
+            check = true;
+        else {
+            PrintUsage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!corpusPath.empty()) {
+        std::ofstream file(corpusPath, std::ios::out | std::ios::binary);
+        file << GC::Bench::GenerateCorpus(options.corpusBytes, options.seed);
+        return file ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (check)
+        return GC::Bench::CheckParallelLexer(options, std::cout) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    std::vector<GC::Bench::Result> results;
+    if (bench == "all" || bench == "keywords") {
+        auto keywordResults = GC::Bench::RunKeywordBench(options);
+        results.insert(results.end(), keywordResults.begin(), keywordResults.end());
+    }
+    if (bench == "all" || bench == "lexer") {
+        auto lexerResults = GC::Bench::RunLexerBench(options);
+        results.insert(results.end(), lexerResults.begin(), lexerResults.end());
+    }
+    if (bench == "all" || bench == "parser") {
+        auto parserResults = GC::Bench::RunParserBench(options);
+        results.insert(results.end(), parserResults.begin(), parserResults.end());
+    }
+    if (results.empty()) {
+        PrintUsage();
+        return EXIT_FAILURE;
+    }
+
+    GC::Bench::Report(std::cout, results, options.json);
+    return 0;
+}
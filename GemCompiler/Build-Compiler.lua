@@ -20,6 +20,53 @@ project "GemCompiler"
        systemversion "latest"
        defines { "WINDOWS" }
 
+   filter "system:linux"
+       links { "pthread" }
+
+   filter "configurations:Debug"
+       defines { "DEBUG", "LEXER_STATS" }
+       runtime "Debug"
+       symbols "On"
+
+   filter "configurations:Release"
+       defines { "RELEASE" }
+       runtime "Release"
+       optimize "On"
+       symbols "On"
+
+   filter "configurations:Dist"
+       defines { "DIST" }
+       runtime "Release"
+       optimize "On"
+       symbols "Off"
+
+project "GemBench"
+   location( _SCRIPT_DIR )
+   kind "ConsoleApp"
+   language "C++"
+   cppdialect "C++20"
+   staticruntime "off"
+
+   -- The benchmarks link the compiler sources directly, minus the compiler entry point.
+   files { "Source/**.h", "Source/**.cpp", "Bench/**.h", "Bench/**.cpp" }
+   removefiles { "Source/main.cpp" }
+
+   includedirs
+   {
+      "Source",
+      "Bench",
+   }
+
+   targetdir ("../Build/" .. OutputDir .. "/%{prj.name}")
+   objdir ("../Build/Intermediates/" .. OutputDir .. "/%{prj.name}")
+
+   filter "system:windows"
+       systemversion "latest"
+       defines { "WINDOWS" }
+
+   filter "system:linux"
+       links { "pthread" }
+
    filter "configurations:Debug"
        defines { "DEBUG" }
        runtime "Debug"
@@ -35,4 +82,4 @@ project "GemCompiler"
        defines { "DIST" }
        runtime "Release"
        optimize "On"
-       symbols "Off"
\ No newline at end of file
+       symbols "Off"
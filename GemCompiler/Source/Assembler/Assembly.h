@@ -1,11 +1,32 @@
 #pragma once
 #include <string>
-#include <vector>
+#include "X64.h"
+#include "../Parse/Ast.h"
 #include "../Token/Token.h"
 
 namespace GC {
 
-    // Converts a vector of tokens into NASM-style assembly code.
-    std::string TokenToASM(const std::vector<GC::Token>& tokens);
+    // The runtime the generated program is written for.
+    enum class Target {
+        Win64,          // main calling ExitProcess (assembled with nasm -f win64, linked by a C toolchain).
+        LinuxLibc,      // main calling exit() (an ELF object linked by cc).
+        LinuxStatic,    // _start ending in the exit syscall (a standalone ELF executable).
+    };
+
+    // Translates a parsed module into a machine program for `target`. Only the
+    // top-level `exitProgram <integer>` statements generate code so far.
+    Program GenerateProgram(const GC::Ast& ast, const GC::TokenStream& tokens, Target target);
+
+    // Translates a token stream into a machine program for `target`, without
+    // parsing: every `exitProgram <integer>` token pair counts.
+    Program GenerateProgram(const GC::TokenStream& tokens, Target target);
+
+    // Same, pulling tokens from the lexer as they are produced instead of
+    // materializing the whole stream first.
+    Program GenerateProgram(GC::Lexer& lexer, Target target);
+
+    // Converts a token stream into NASM-style assembly code (Win64).
+    std::string TokenToASM(const GC::TokenStream& tokens);
+    std::string TokenToASM(GC::Lexer& lexer);
 
 } // namespace GC
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "X64.h"
+
+namespace GC {
+
+    //------------------------------------------------------------------------------
+    // ELF64 Writer (x86-64 Linux)
+    //
+    // Builds the files in memory from an encoded program:
+    //  - ElfObject: a relocatable object (.o) defining the program's entry symbol,
+    //    with calls to its externs left as relocations for the system linker.
+    //  - ElfExecutable: a static executable with a single read/execute segment
+    //    and the code as its entry point. It has nothing to link against, so it
+    //    fails (returns false) when the program calls an external function.
+    //------------------------------------------------------------------------------
+    std::vector<uint8_t> ElfObject(const Program& program, const MachineCode& code);
+    bool ElfExecutable(const Program& program, const MachineCode& code, std::vector<uint8_t>& out, std::string& error);
+
+    // Writes `bytes` to `path`, marking the file executable when asked.
+    bool WriteBinary(const std::string& path, const std::vector<uint8_t>& bytes, bool executable, std::string& error);
+
+} // namespace GC
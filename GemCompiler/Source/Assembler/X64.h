@@ -0,0 +1,83 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace GC {
+
+    //------------------------------------------------------------------------------
+    // 1. Machine Program
+    //
+    // The code generator's output: a flat list of x86-64 instructions plus the
+    // entry symbol and the external functions they call. It is both encoded to
+    // machine code in process (Encode below) and printed as NASM text for
+    // debugging (FormatNasm), so the two can never disagree.
+    //------------------------------------------------------------------------------
+    enum class Reg : uint8_t {
+        Rax, Rcx, Rdx, Rbx, Rsp, Rbp, Rsi, Rdi,
+        R8, R9, R10, R11, R12, R13, R14, R15,
+    };
+
+    enum class Op : uint8_t {
+        SubImm,         // sub reg, imm32
+        MovImm,         // mov reg, imm64
+        CallExternal,   // call symbol
+        Syscall,        // syscall
+    };
+
+    struct Instruction {
+        Op op;
+        Reg reg;
+        uint32_t symbol;    // CallExternal: index into Program::externs.
+        uint64_t imm;
+    };
+
+    class Program {
+    public:
+        explicit Program(std::string entry = "main")
+            : entry_(std::move(entry)) {}
+
+        void sub(Reg reg, uint32_t imm) { code_.push_back(Instruction{ Op::SubImm, reg, 0, imm }); }
+        void mov(Reg reg, uint64_t imm) { code_.push_back(Instruction{ Op::MovImm, reg, 0, imm }); }
+        void call(std::string_view external) { code_.push_back(Instruction{ Op::CallExternal, Reg::Rax, declare(external), 0 }); }
+        void syscall() { code_.push_back(Instruction{ Op::Syscall, Reg::Rax, 0, 0 }); }
+
+        const std::string& entry() const noexcept { return entry_; }
+        const std::vector<std::string>& externs() const noexcept { return externs_; }
+        const std::vector<Instruction>& code() const noexcept { return code_; }
+
+    private:
+        uint32_t declare(std::string_view external);
+
+        std::string entry_;
+        std::vector<std::string> externs_;
+        std::vector<Instruction> code_;
+    };
+
+    //------------------------------------------------------------------------------
+    // 2. Encoding
+    //
+    // Calls to external functions are left as rel32 placeholders with a relocation
+    // for the object writer (ELF R_X86_64_PLT32 semantics: S + A - P, A = -4).
+    //------------------------------------------------------------------------------
+    struct Relocation {
+        uint32_t offset;    // Of the rel32 field in the code.
+        uint32_t symbol;    // Index into Program::externs.
+        int64_t addend;
+    };
+
+    struct MachineCode {
+        std::vector<uint8_t> bytes;
+        std::vector<Relocation> relocations;
+    };
+
+    MachineCode Encode(const Program& program);
+
+    // NASM source for the same program (`nasm -f win64` or `-f elf64`).
+    std::string FormatNasm(const Program& program);
+
+    std::string_view RegName(Reg reg) noexcept;
+
+} // namespace GC
@@ -2,37 +2,115 @@
 
 namespace GC {
 
-    std::string TokenToASM(const std::vector<GC::Token>& tokens) {
-        // Begin our assembly output with a basic program header.
-        std::string outputASM =
-            "section .text\n"
-            "global main\n"
-            "extern ExitProcess\n\n"
-            "main:\n";
+    namespace {
+
+        //------------------------------------------------------------------------------
+        // Program shape per target: where the exit code goes, what runs first, and
+        // how the program ends.
+        //------------------------------------------------------------------------------
+        Program BeginProgram(Target target) {
+            Program program(target == Target::LinuxStatic ? "_start" : "main");
+            if (target != Target::Win64) {
+                // A program without an exit statement exits with 0.
+                program.mov(Reg::Rdi, 0);
+            }
+            if (target == Target::LinuxLibc) {
+                // Realign the stack to 16 bytes for the call to exit().
+                program.sub(Reg::Rsp, 8);
+            }
+            return program;
+        }
+
+        void EmitExit(Program& program, Target target, uint64_t exitCode) {
+            if (target == Target::Win64) {
+                // Add shadow space + 8 bytes alignment.
+                program.sub(Reg::Rsp, 40);
+                // Move the integer literal (parsed by the lexer) into RCX.
+                program.mov(Reg::Rcx, exitCode);
+            }
+            else {
+                program.mov(Reg::Rdi, exitCode);
+            }
+        }
+
+        void EndProgram(Program& program, Target target) {
+            switch (target) {
+            case Target::Win64:
+                program.call("ExitProcess");
+                break;
+            case Target::LinuxLibc:
+                program.call("exit");
+                break;
+            case Target::LinuxStatic:
+                program.mov(Reg::Rax, 60);  // SYS_exit
+                program.syscall();
+                break;
+            }
+        }
+
+    } // namespace
+
+    Program GenerateProgram(const GC::Ast& ast, const GC::TokenStream& tokens, Target target) {
+        Program program = BeginProgram(target);
+
+        for (NodeId item : ast.list(ast[ast.root()].lhs)) {
+            const Node& node = ast[item];
+            if (node.kind != NodeKind::Exit)
+                continue;
+            const Node& code = ast[node.lhs];
+            if (code.kind == NodeKind::Literal && tokens.kind(code.token) == GC::TokenType::IntegerLiteral)
+                EmitExit(program, target, tokens.getLiteral<uint64_t>(code.token).value_or(0));
+        }
+
+        EndProgram(program, target);
+        return program;
+    }
+
+    Program GenerateProgram(const GC::TokenStream& tokens, Target target) {
+        Program program = BeginProgram(target);
 
         size_t tk_len = tokens.size();
 
         // A very simple parser example that only handles a return statement with an integer literal.
         for (size_t i = 0; i < tk_len; i++) {
-            const GC::Token& token = tokens[i];
-
-            // Check for a 'return' token.
-            if (token.getType() == GC::TokenType::ExitProgram) {
+            // Check for a 'return' token. Only the 1-byte kinds are read until one matches.
+            if (tokens.kind(i) == GC::TokenType::ExitProgram) {
                 // Ensure the next token is an integer literal
-                bool nextParamInt = (i + 1 < tk_len && tokens[i + 1].getType() == GC::TokenType::IntegerLiteral);
+                bool nextParamInt = (i + 1 < tk_len && tokens.kind(i + 1) == GC::TokenType::IntegerLiteral);
 
                 if (nextParamInt) {
-					// Add shadow space + 8 bytes alignment.
-                    outputASM += "    sub rsp, 40\n";
-                    // Generate the assembly to move the integer literal into RCX.
                     // We advance the index to consume the integer literal token.
-                    outputASM += "    mov rcx, " + tokens[++i].getLexeme() + "\n";
+                    EmitExit(program, target, tokens.getLiteral<uint64_t>(++i).value_or(0));
                 }
             }
         }
 
-        outputASM += "    call ExitProcess\n";
-        return outputASM;
+        EndProgram(program, target);
+        return program;
+    }
+
+    Program GenerateProgram(GC::Lexer& lexer, Target target) {
+        Program program = BeginProgram(target);
+
+        // Same translation as above, pulling tokens one at a time.
+        for (GC::Token token = lexer.next(); token.getType() != GC::TokenType::EndOfFile; token = lexer.next()) {
+            if (token.getType() == GC::TokenType::ExitProgram &&
+                lexer.peekToken().getType() == GC::TokenType::IntegerLiteral)
+            {
+                EmitExit(program, target, lexer.next().getLiteral<uint64_t>().value_or(0));
+            }
+        }
+
+        EndProgram(program, target);
+        return program;
+    }
+
+    std::string TokenToASM(const GC::TokenStream& tokens) {
+        return FormatNasm(GenerateProgram(tokens, Target::Win64));
+    }
+
+    std::string TokenToASM(GC::Lexer& lexer) {
+        return FormatNasm(GenerateProgram(lexer, Target::Win64));
     }
 
 } // namespace GC
@@ -0,0 +1,296 @@
+#include "../Elf.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+
+namespace GC {
+
+    namespace {
+
+        //------------------------------------------------------------------------------
+        // 1. ELF64 Structures (little-endian x86-64, per the System V gABI)
+        //------------------------------------------------------------------------------
+        struct FileHeader {
+            uint8_t ident[16];
+            uint16_t type;
+            uint16_t machine;
+            uint32_t version;
+            uint64_t entry;
+            uint64_t phoff;
+            uint64_t shoff;
+            uint32_t flags;
+            uint16_t ehsize;
+            uint16_t phentsize;
+            uint16_t phnum;
+            uint16_t shentsize;
+            uint16_t shnum;
+            uint16_t shstrndx;
+        };
+
+        struct ProgramHeader {
+            uint32_t type;
+            uint32_t flags;
+            uint64_t offset;
+            uint64_t vaddr;
+            uint64_t paddr;
+            uint64_t filesz;
+            uint64_t memsz;
+            uint64_t align;
+        };
+
+        struct SectionHeader {
+            uint32_t name;
+            uint32_t type;
+            uint64_t flags;
+            uint64_t addr;
+            uint64_t offset;
+            uint64_t size;
+            uint32_t link;
+            uint32_t info;
+            uint64_t addralign;
+            uint64_t entsize;
+        };
+
+        struct Symbol {
+            uint32_t name;
+            uint8_t info;
+            uint8_t other;
+            uint16_t shndx;
+            uint64_t value;
+            uint64_t size;
+        };
+
+        struct Rela {
+            uint64_t offset;
+            uint64_t info;
+            int64_t addend;
+        };
+
+        static_assert(sizeof(FileHeader) == 64 && sizeof(ProgramHeader) == 56 && sizeof(SectionHeader) == 64
+            && sizeof(Symbol) == 24 && sizeof(Rela) == 24, "ELF64 structures must not be padded");
+
+        constexpr uint16_t TypeRelocatable = 1;
+        constexpr uint16_t TypeExecutable = 2;
+        constexpr uint16_t MachineX86_64 = 62;
+
+        constexpr uint32_t SectionProgBits = 1;
+        constexpr uint32_t SectionSymTab = 2;
+        constexpr uint32_t SectionStrTab = 3;
+        constexpr uint32_t SectionRela = 4;
+        constexpr uint64_t SectionAlloc = 0x2;
+        constexpr uint64_t SectionExec = 0x4;
+        constexpr uint64_t SectionInfoLink = 0x40;
+
+        constexpr uint8_t BindLocal = 0;
+        constexpr uint8_t BindGlobal = 1;
+        constexpr uint8_t SymbolNoType = 0;
+        constexpr uint8_t SymbolFunc = 2;
+        constexpr uint8_t SymbolSection = 3;
+        constexpr uint32_t RelocationPlt32 = 4;
+
+        constexpr uint32_t SegmentLoad = 1;
+        constexpr uint32_t SegmentGnuStack = 0x6474E551;
+        constexpr uint32_t SegmentExecute = 0x1;
+        constexpr uint32_t SegmentWrite = 0x2;
+        constexpr uint32_t SegmentRead = 0x4;
+
+        // Where the static executable is loaded; the traditional x86-64 base.
+        constexpr uint64_t ImageBase = 0x400000;
+
+        FileHeader MakeFileHeader(uint16_t type) {
+            FileHeader header{};
+            const uint8_t ident[16] = { 0x7F, 'E', 'L', 'F', 2 /* 64-bit */, 1 /* little-endian */, 1 /* version */ };
+            std::memcpy(header.ident, ident, sizeof(ident));
+            header.type = type;
+            header.machine = MachineX86_64;
+            header.version = 1;
+            header.ehsize = sizeof(FileHeader);
+            return header;
+        }
+
+        SectionHeader MakeSection(uint32_t name, uint32_t type, uint64_t flags = 0) {
+            SectionHeader section{};
+            section.name = name;
+            section.type = type;
+            section.flags = flags;
+            return section;
+        }
+
+        //------------------------------------------------------------------------------
+        // 2. Image Builder
+        //------------------------------------------------------------------------------
+        class Image {
+        public:
+            template<typename T>
+            size_t put(const T& value) {
+                return put(&value, sizeof(value));
+            }
+
+            size_t put(const void* data, size_t size) {
+                size_t at = bytes_.size();
+                bytes_.resize(at + size);
+                if (size)
+                    std::memcpy(bytes_.data() + at, data, size);
+                return at;
+            }
+
+            size_t align(size_t alignment) {
+                bytes_.resize((bytes_.size() + alignment - 1) / alignment * alignment);
+                return bytes_.size();
+            }
+
+            template<typename T>
+            void patch(size_t at, const T& value) {
+                std::memcpy(bytes_.data() + at, &value, sizeof(value));
+            }
+
+            std::vector<uint8_t>& bytes() { return bytes_; }
+
+        private:
+            std::vector<uint8_t> bytes_;
+        };
+
+        // A string table: NUL-separated names, starting with the empty name.
+        class StringTable {
+        public:
+            uint32_t add(std::string_view name) {
+                uint32_t at = static_cast<uint32_t>(text_.size());
+                text_.append(name);
+                text_.push_back('\0');
+                return at;
+            }
+
+            const std::string& text() const { return text_; }
+
+        private:
+            std::string text_{ '\0' };
+        };
+
+    } // namespace
+
+    //------------------------------------------------------------------------------
+    // 3. Relocatable Object
+    //
+    // Sections: null, .text, .rela.text, .symtab, .strtab, .shstrtab, and an empty
+    // .note.GNU-stack so that linkers keep the stack non-executable. Symbols: null,
+    // the .text section, the entry point, then one undefined symbol per extern.
+    //------------------------------------------------------------------------------
+    std::vector<uint8_t> ElfObject(const Program& program, const MachineCode& code) {
+        enum : uint16_t { Null, Text, RelaText, SymTab, StrTab, ShStrTab, NoteStack, SectionCount };
+        constexpr uint32_t FirstExtern = 3;
+
+        StringTable sectionNames;
+        StringTable symbolNames;
+        std::vector<SectionHeader> sections(SectionCount);
+        sections[Text] = MakeSection(sectionNames.add(".text"), SectionProgBits, SectionAlloc | SectionExec);
+        sections[RelaText] = MakeSection(sectionNames.add(".rela.text"), SectionRela, SectionInfoLink);
+        sections[SymTab] = MakeSection(sectionNames.add(".symtab"), SectionSymTab);
+        sections[StrTab] = MakeSection(sectionNames.add(".strtab"), SectionStrTab);
+        sections[ShStrTab] = MakeSection(sectionNames.add(".shstrtab"), SectionStrTab);
+        sections[NoteStack] = MakeSection(sectionNames.add(".note.GNU-stack"), SectionProgBits);
+
+        std::vector<Symbol> symbols(FirstExtern);
+        symbols[1] = Symbol{ 0, static_cast<uint8_t>((BindLocal << 4) | SymbolSection), 0, Text, 0, 0 };
+        symbols[2] = Symbol{ symbolNames.add(program.entry()), static_cast<uint8_t>((BindGlobal << 4) | SymbolFunc), 0,
+            Text, 0, code.bytes.size() };
+        for (const std::string& external : program.externs())
+            symbols.push_back(Symbol{ symbolNames.add(external), static_cast<uint8_t>((BindGlobal << 4) | SymbolNoType), 0, 0, 0, 0 });
+
+        Image image;
+        image.put(FileHeader{});
+
+        const auto place = [&](SectionHeader& section, const void* data, size_t size, size_t alignment, size_t entrySize) {
+            section.offset = image.align(alignment);
+            image.put(data, size);
+            section.size = size;
+            section.addralign = alignment;
+            section.entsize = entrySize;
+        };
+
+        place(sections[Text], code.bytes.data(), code.bytes.size(), 16, 0);
+
+        std::vector<Rela> relocations;
+        for (const Relocation& relocation : code.relocations) {
+            uint64_t symbol = FirstExtern + relocation.symbol;
+            relocations.push_back(Rela{ relocation.offset, (symbol << 32) | RelocationPlt32, relocation.addend });
+        }
+        place(sections[RelaText], relocations.data(), relocations.size() * sizeof(Rela), 8, sizeof(Rela));
+        sections[RelaText].link = SymTab;
+        sections[RelaText].info = Text;
+
+        place(sections[SymTab], symbols.data(), symbols.size() * sizeof(Symbol), 8, sizeof(Symbol));
+        sections[SymTab].link = StrTab;
+        sections[SymTab].info = 2;  // Index of the first global symbol.
+
+        place(sections[StrTab], symbolNames.text().data(), symbolNames.text().size(), 1, 0);
+        place(sections[ShStrTab], sectionNames.text().data(), sectionNames.text().size(), 1, 0);
+        place(sections[NoteStack], nullptr, 0, 1, 0);
+
+        FileHeader header = MakeFileHeader(TypeRelocatable);
+        header.shoff = image.align(8);
+        header.shentsize = sizeof(SectionHeader);
+        header.shnum = SectionCount;
+        header.shstrndx = ShStrTab;
+        for (const SectionHeader& section : sections)
+            image.put(section);
+        image.patch(0, header);
+        return std::move(image.bytes());
+    }
+
+    //------------------------------------------------------------------------------
+    // 4. Static Executable
+    //
+    // Header, a PT_LOAD segment mapping the whole file read/execute at ImageBase,
+    // a PT_GNU_STACK marking the stack non-executable, then the code.
+    //------------------------------------------------------------------------------
+    bool ElfExecutable(const Program& program, const MachineCode& code, std::vector<uint8_t>& out, std::string& error) {
+        if (!code.relocations.empty()) {
+            error = "a static executable cannot call external function '" + program.externs()[code.relocations[0].symbol] + "'";
+            return false;
+        }
+
+        constexpr uint64_t CodeOffset = sizeof(FileHeader) + 2 * sizeof(ProgramHeader);
+        const uint64_t fileSize = CodeOffset + code.bytes.size();
+
+        FileHeader header = MakeFileHeader(TypeExecutable);
+        header.entry = ImageBase + CodeOffset;
+        header.phoff = sizeof(FileHeader);
+        header.phentsize = sizeof(ProgramHeader);
+        header.phnum = 2;
+
+        Image image;
+        image.put(header);
+        image.put(ProgramHeader{ SegmentLoad, SegmentRead | SegmentExecute, 0, ImageBase, ImageBase, fileSize, fileSize, 0x1000 });
+        image.put(ProgramHeader{ SegmentGnuStack, SegmentRead | SegmentWrite, 0, 0, 0, 0, 0, 16 });
+        image.put(code.bytes.data(), code.bytes.size());
+        out = std::move(image.bytes());
+        return true;
+    }
+
+    //------------------------------------------------------------------------------
+    // 5. Output
+    //------------------------------------------------------------------------------
+    bool WriteBinary(const std::string& path, const std::vector<uint8_t>& bytes, bool executable, std::string& error) {
+        std::FILE* stream = std::fopen(path.c_str(), "wb");
+        if (!stream) {
+            error = std::strerror(errno);
+            return false;
+        }
+        bool written = std::fwrite(bytes.data(), 1, bytes.size(), stream) == bytes.size();
+        written = std::fclose(stream) == 0 && written;
+        if (!written) {
+            error = "write error";
+            return false;
+        }
+        if (executable) {
+            std::error_code ec;
+            std::filesystem::permissions(path, std::filesystem::perms::owner_exec | std::filesystem::perms::group_exec
+                | std::filesystem::perms::others_exec, std::filesystem::perm_options::add, ec);
+        }
+        return true;
+    }
+
+} // namespace GC
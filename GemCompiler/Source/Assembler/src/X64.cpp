@@ -0,0 +1,145 @@
+#include "../X64.h"
+
+namespace GC {
+
+    uint32_t Program::declare(std::string_view external) {
+        for (size_t i = 0; i < externs_.size(); i++) {
+            if (externs_[i] == external)
+                return static_cast<uint32_t>(i);
+        }
+        externs_.emplace_back(external);
+        return static_cast<uint32_t>(externs_.size() - 1);
+    }
+
+    std::string_view RegName(Reg reg) noexcept {
+        static constexpr std::string_view Names[] = {
+            "rax", "rcx", "rdx", "rbx", "rsp", "rbp", "rsi", "rdi",
+            "r8", "r9", "r10", "r11", "r12", "r13", "r14", "r15",
+        };
+        return Names[static_cast<size_t>(reg)];
+    }
+
+    namespace {
+
+        //------------------------------------------------------------------------------
+        // Byte emission helpers. REX is 0100WRXB; only W (64-bit operand) and B (the
+        // high bit of the ModRM.rm / opcode register) are ever needed here.
+        //------------------------------------------------------------------------------
+        class Emitter {
+        public:
+            explicit Emitter(MachineCode& code) : code_(code) {}
+
+            void byte(uint8_t value) { code_.bytes.push_back(value); }
+
+            void imm32(uint32_t value) {
+                for (int i = 0; i < 4; i++)
+                    byte(static_cast<uint8_t>(value >> (8 * i)));
+            }
+
+            void imm64(uint64_t value) {
+                for (int i = 0; i < 8; i++)
+                    byte(static_cast<uint8_t>(value >> (8 * i)));
+            }
+
+            void rex(bool wide, Reg reg) {
+                uint8_t bits = 0x40 | (wide ? 0x08 : 0) | (Low(reg) != static_cast<uint8_t>(reg) ? 0x01 : 0);
+                if (bits != 0x40)
+                    byte(bits);
+            }
+
+            // ModRM with a register operand (mod = 11).
+            void modrm(uint8_t extension, Reg reg) { byte(static_cast<uint8_t>(0xC0 | (extension << 3) | Low(reg))); }
+
+            uint32_t position() const { return static_cast<uint32_t>(code_.bytes.size()); }
+
+            static uint8_t Low(Reg reg) { return static_cast<uint8_t>(reg) & 7; }
+
+        private:
+            MachineCode& code_;
+        };
+
+    } // namespace
+
+    //------------------------------------------------------------------------------
+    // Encode: picks the shortest form of each instruction.
+    //------------------------------------------------------------------------------
+    MachineCode Encode(const Program& program) {
+        MachineCode code;
+        Emitter out(code);
+        for (const Instruction& instruction : program.code()) {
+            switch (instruction.op) {
+            case Op::SubImm:
+                // REX.W 83 /5 ib, or REX.W 81 /5 id.
+                out.rex(true, instruction.reg);
+                if (instruction.imm <= 0x7F) {
+                    out.byte(0x83);
+                    out.modrm(5, instruction.reg);
+                    out.byte(static_cast<uint8_t>(instruction.imm));
+                }
+                else {
+                    out.byte(0x81);
+                    out.modrm(5, instruction.reg);
+                    out.imm32(static_cast<uint32_t>(instruction.imm));
+                }
+                break;
+
+            case Op::MovImm:
+                // B8+r id writes the 32-bit register and zero-extends; REX.W B8+r io
+                // only when the value needs all 64 bits.
+                if (instruction.imm <= UINT32_MAX) {
+                    out.rex(false, instruction.reg);
+                    out.byte(static_cast<uint8_t>(0xB8 + Emitter::Low(instruction.reg)));
+                    out.imm32(static_cast<uint32_t>(instruction.imm));
+                }
+                else {
+                    out.rex(true, instruction.reg);
+                    out.byte(static_cast<uint8_t>(0xB8 + Emitter::Low(instruction.reg)));
+                    out.imm64(instruction.imm);
+                }
+                break;
+
+            case Op::CallExternal:
+                // E8 rel32, resolved by the linker.
+                out.byte(0xE8);
+                code.relocations.push_back(Relocation{ out.position(), instruction.symbol, -4 });
+                out.imm32(0);
+                break;
+
+            case Op::Syscall:
+                out.byte(0x0F);
+                out.byte(0x05);
+                break;
+            }
+        }
+        return code;
+    }
+
+    //------------------------------------------------------------------------------
+    // FormatNasm: the debug listing (--emit-asm).
+    //------------------------------------------------------------------------------
+    std::string FormatNasm(const Program& program) {
+        std::string text = "section .text\n";
+        text += "global " + program.entry() + "\n";
+        for (const std::string& external : program.externs())
+            text += "extern " + external + "\n";
+        text += "\n" + program.entry() + ":\n";
+        for (const Instruction& instruction : program.code()) {
+            switch (instruction.op) {
+            case Op::SubImm:
+                text += "    sub " + std::string(RegName(instruction.reg)) + ", " + std::to_string(instruction.imm) + "\n";
+                break;
+            case Op::MovImm:
+                text += "    mov " + std::string(RegName(instruction.reg)) + ", " + std::to_string(instruction.imm) + "\n";
+                break;
+            case Op::CallExternal:
+                text += "    call " + program.externs()[instruction.symbol] + "\n";
+                break;
+            case Op::Syscall:
+                text += "    syscall\n";
+                break;
+            }
+        }
+        return text;
+    }
+
+} // namespace GC
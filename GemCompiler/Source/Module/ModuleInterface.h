@@ -0,0 +1,131 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "../Parse/Ast.h"
+#include "../Token/Token.h"
+#include "../Unit/CompilationContext.h"
+#include "../Unit/SourceFile.h"
+
+namespace GC {
+
+    //------------------------------------------------------------------------------
+    // 1. Module Interfaces
+    //
+    // What an importer needs from a module, without its source: every top-level
+    // class, function and enum with its signature, the members of classes, and
+    // the bodies of generic functions and classes (templates, instantiated by the
+    // importer). Other function bodies and top-level statements are left out.
+    //
+    // The interface is the tree the parser builds (Ast.h), pruned: the same 16-byte
+    // nodes, lists and records, except that a node's token indexes the interface's
+    // own token table, which keeps the kind and text of every token a node refers
+    // to. It is stored in a `.gemi` file next to the source and used where it is
+    // mapped: every reference is an index into one of the file's arrays, so the
+    // view needs no pointer fix-ups and no decoding pass, just a check of the
+    // header, of a hash of the body and of the bounds of every index.
+    //------------------------------------------------------------------------------
+    class ModuleInterface {
+    public:
+        // A source the interface was built from: the module's imports and theirs.
+        struct Dependency {
+            uint64_t hash;              // Hash64 of the source bytes.
+            uint64_t size;
+            uint32_t path;              // Into the string bytes, relative to the .gemi's directory.
+            uint32_t pathLength;
+        };
+
+        struct TokenRecord {
+            TokenType kind;
+            uint8_t reserved[3];
+            uint32_t text;              // Into the string bytes.
+            uint32_t length;
+        };
+
+        ModuleInterface() = default;
+
+        // Views a .gemi image. Returns false unless the image is a complete interface
+        // written by this compiler (the header, the section sizes, the body hash and
+        // every node, list, record, token and string index are checked; nothing is
+        // copied).
+        static bool Open(SourceFile image, ModuleInterface& out);
+
+        NodeId root() const noexcept { return root_; }
+        size_t size() const noexcept { return nodes_.size(); }
+        const Node& operator[](NodeId id) const noexcept { return nodes_[id]; }
+        std::span<const Node> nodes() const noexcept { return nodes_; }
+
+        std::span<const NodeId> list(ListRef ref) const noexcept { return extra_.subspan(ref + 1, extra_[ref]); }
+
+        FunctionData function(NodeId id) const noexcept {
+            const uint32_t* record = extra_.data() + nodes_[id].lhs;
+            return FunctionData{ record[0], record[1], record[2] };
+        }
+        ClassData classData(NodeId id) const noexcept {
+            const uint32_t* record = extra_.data() + nodes_[id].lhs;
+            return ClassData{ record[0], record[1], record[2] };
+        }
+        EnumData enumeration(NodeId id) const noexcept {
+            const uint32_t* record = extra_.data() + nodes_[id].lhs;
+            return EnumData{ record[0], record[1] };
+        }
+        IterData iter(NodeId id) const noexcept {
+            const uint32_t* record = extra_.data() + nodes_[id].lhs;
+            return IterData{ record[0], record[1] };
+        }
+        IfData branches(NodeId id) const noexcept {
+            const uint32_t* record = extra_.data() + nodes_[id].rhs;
+            return IfData{ record[0], record[1] };
+        }
+
+        // The token node `id` is anchored at.
+        TokenType tokenKind(NodeId id) const noexcept { return tokens_[nodes_[id].token].kind; }
+        std::string_view text(NodeId id) const noexcept {
+            const TokenRecord& token = tokens_[nodes_[id].token];
+            return strings_.substr(token.text, token.length);
+        }
+
+        std::span<const Dependency> dependencies() const noexcept { return dependencies_; }
+        std::string_view path(const Dependency& dependency) const noexcept {
+            return strings_.substr(dependency.path, dependency.pathLength);
+        }
+
+        uint64_t sourceHash() const noexcept { return sourceHash_; }
+        uint64_t sourceSize() const noexcept { return sourceSize_; }
+
+    private:
+        SourceFile image_;
+        std::span<const Dependency> dependencies_;
+        std::span<const Node> nodes_;
+        std::span<const uint32_t> extra_;
+        std::span<const TokenRecord> tokens_;
+        std::string_view strings_;
+        NodeId root_{ InvalidNode };
+        uint64_t sourceHash_{ 0 };
+        uint64_t sourceSize_{ 0 };
+    };
+
+    //------------------------------------------------------------------------------
+    // 2. Importing
+    //------------------------------------------------------------------------------
+
+    // Where `import &"name"` in the file at `importer` points: `name` relative to the
+    // importer's directory, with ".gem" appended when it has no extension.
+    std::string ResolveImport(std::string_view importer, std::string_view name);
+
+    // `path` with its extension replaced by ".gemi".
+    std::string InterfacePath(std::string_view path);
+
+    // The interface of the module at `path`, imported by the file at `importer`.
+    // The .gemi next to it is mapped when it was built from the current bytes of
+    // the source and of every module it imports, directly or not; otherwise the
+    // module (and any stale import) is lexed, parsed with lazy bodies and its
+    // interface written back. An import of `importer` further down is a cycle: it
+    // is recorded as a dependency, not built. On failure (a missing file, a syntax
+    // error) returns false and fills `error`.
+    bool ImportModule(const std::string& path, const std::string& importer, ModuleInterface& out, std::string& error,
+        CompilationContext& context = CompilationContext::Global());
+
+} // namespace GC
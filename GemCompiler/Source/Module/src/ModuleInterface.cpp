@@ -0,0 +1,615 @@
+#include "../ModuleInterface.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "../../Parse/Parser.h"
+#include "../../Unit/CompilationUnit.h"
+#include "../../Unit/Diagnostic.h"
+#include "../../Unit/Hash.h"
+#include "../../Version.h"
+
+namespace GC {
+
+    namespace {
+
+        //------------------------------------------------------------------------------
+        // 1. File Format
+        //
+        // A fixed header, then the body: the dependency records, the nodes, the extra
+        // array, the token records, and last the bytes of every string they refer
+        // to. The header is a multiple of 8 bytes and the sections are in decreasing
+        // order of alignment, so every array of a mapped file is aligned for its
+        // type. Integers are in host byte order (the header carries a mark to check
+        // it), like the token cache.
+        //------------------------------------------------------------------------------
+        constexpr char Magic[8] = { 'G', 'E', 'M', 'I', 'N', 'T', 'F', '\0' };
+        constexpr uint32_t FormatVersion = 1;
+        constexpr uint32_t EndianMark = 0x01020304;
+
+        struct Header {
+            char magic[8];
+            uint32_t format;
+            uint32_t endianMark;
+            uint64_t versionSeed;       // VersionSeed() of the compiler that wrote the file.
+            uint64_t sourceHash;        // Hash64 of the module's source.
+            uint64_t sourceSize;
+            uint64_t bodySize;
+            uint64_t bodyHash;
+            uint32_t dependencyCount;
+            uint32_t nodeCount;
+            uint32_t extraCount;
+            uint32_t tokenCount;
+            uint32_t stringBytes;
+            uint32_t root;
+        };
+
+        static_assert(sizeof(Header) % alignof(ModuleInterface::Dependency) == 0, "Sections must stay aligned");
+        static_assert(sizeof(ModuleInterface::Dependency) % alignof(Node) == 0, "Sections must stay aligned");
+        static_assert(sizeof(ModuleInterface::TokenRecord) == 12, "Token records are part of the file format");
+
+        struct Layout {
+            size_t dependencies, nodes, extra, tokens, strings, end;
+        };
+
+        Layout ComputeLayout(const Header& header) {
+            Layout layout{};
+            size_t at = 0;
+            layout.dependencies = at;   at += size_t{ header.dependencyCount } * sizeof(ModuleInterface::Dependency);
+            layout.nodes = at;          at += size_t{ header.nodeCount } * sizeof(Node);
+            layout.extra = at;          at += size_t{ header.extraCount } * sizeof(uint32_t);
+            layout.tokens = at;         at += size_t{ header.tokenCount } * sizeof(ModuleInterface::TokenRecord);
+            layout.strings = at;        at += header.stringBytes;
+            layout.end = at;
+            return layout;
+        }
+
+        // Interfaces are tied to the compiler version, every node kind in enum
+        // order, the node and record layouts and the token table, so a new
+        // compiler or a changed grammar rebuilds them.
+        uint64_t VersionSeed() {
+            static const uint64_t seed = [] {
+                uint64_t hash = Hash64(CompilerVersion, FormatVersion);
+                for (uint32_t k = 0; k <= static_cast<uint32_t>(NodeKind::Array); k++)
+                    hash = Hash64(NodeKindName(static_cast<NodeKind>(k)), hash ^ k);
+                const uint64_t layouts[] = { sizeof(Node), sizeof(FunctionData), sizeof(ClassData),
+                    sizeof(EnumData), sizeof(IterData), sizeof(IfData) };
+                hash = Hash64(layouts, sizeof(layouts), hash);
+                for (const TokenSpelling& spelling : TokenSpellings)
+                    hash = Hash64(spelling.text, hash ^ static_cast<uint64_t>(spelling.category));
+                return hash;
+            }();
+            return seed;
+        }
+
+        template<typename T>
+        std::span<const T> Section(std::string_view body, size_t at, size_t count) {
+            return std::span<const T>(reinterpret_cast<const T*>(body.data() + at), count);
+        }
+
+        bool ValidRef(uint32_t offset, uint32_t length, uint32_t stringBytes) {
+            return uint64_t{ offset } + length <= stringBytes;
+        }
+
+        // Every index a view hands out is checked once when the file is opened, in
+        // one pass over the sections: the body hash is not cryptographic, and a
+        // .gemi can be copied around with its sources. Node ids must point at
+        // earlier nodes, as the builder creates them, so the tree has no cycles;
+        // every list and record must belong to a single node, so the pass stays
+        // linear whatever the file claims.
+        class TreeChecker {
+        public:
+            TreeChecker(std::span<const Node> nodes, std::span<const uint32_t> extra, uint32_t tokenCount)
+                : nodes_(nodes), extra_(extra), tokenCount_(tokenCount), claimed_(extra.size(), false) {}
+
+            bool run() {
+                if (extra_[0] != 0)
+                    return false;
+                for (NodeId id = 0; id < nodes_.size(); id++) {
+                    if (!check(id))
+                        return false;
+                }
+                return true;
+            }
+
+        private:
+            bool check(NodeId id) {
+                const Node& n = nodes_[id];
+                // The module root is the only node anchored at no token.
+                if (n.kind > NodeKind::Array || (n.kind != NodeKind::Module && n.token >= tokenCount_))
+                    return false;
+                switch (n.kind) {
+                case NodeKind::Module:
+                case NodeKind::Block:
+                case NodeKind::Import:
+                case NodeKind::NamedType:
+                case NodeKind::TupleType:
+                case NodeKind::Tuple:
+                case NodeKind::Array:
+                    return list(n.lhs, id);
+                case NodeKind::Function:
+                    return record(n.lhs, 3) && list(extra_[n.lhs], id) && list(extra_[n.lhs + 1], id)
+                        && node(extra_[n.lhs + 2], id) && node(n.rhs, id);
+                case NodeKind::Class:
+                    return record(n.lhs, 3) && list(extra_[n.lhs], id) && node(extra_[n.lhs + 1], id)
+                        && list(extra_[n.lhs + 2], id) && list(n.rhs, id);
+                case NodeKind::Enum:
+                    return record(n.lhs, 2) && list(extra_[n.lhs], id) && node(extra_[n.lhs + 1], id) && list(n.rhs, id);
+                case NodeKind::Iter:
+                    return record(n.lhs, 2) && node(extra_[n.lhs], id) && list(extra_[n.lhs + 1], id) && node(n.rhs, id);
+                case NodeKind::If:
+                    return node(n.lhs, id) && record(n.rhs, 2) && node(extra_[n.rhs], id) && node(extra_[n.rhs + 1], id);
+                case NodeKind::Compare:
+                case NodeKind::Call:
+                    return node(n.lhs, id) && list(n.rhs, id);
+                case NodeKind::LazyBody:
+                    // Refers to the tokens of a source the interface does not keep.
+                    return false;
+                default:
+                    return node(n.lhs, id) && node(n.rhs, id);
+                }
+            }
+
+            bool node(NodeId child, NodeId parent) const {
+                return child == InvalidNode || child < parent;
+            }
+
+            // Claims the `size` words at `at` for one node.
+            bool record(uint32_t at, size_t size) {
+                if (at == EmptyList || at >= extra_.size() || size > extra_.size() - at)
+                    return false;
+                for (size_t i = at; i < at + size; i++) {
+                    if (claimed_[i])
+                        return false;
+                    claimed_[i] = true;
+                }
+                return true;
+            }
+
+            bool list(ListRef ref, NodeId parent) {
+                if (ref == EmptyList)
+                    return true;
+                if (ref >= extra_.size() || !record(ref, size_t{ extra_[ref] } + 1))
+                    return false;
+                for (NodeId child : extra_.subspan(ref + 1, extra_[ref])) {
+                    if (child >= parent)
+                        return false;
+                }
+                return true;
+            }
+
+            std::span<const Node> nodes_;
+            std::span<const uint32_t> extra_;
+            uint32_t tokenCount_;
+            std::vector<bool> claimed_;
+        };
+
+        //------------------------------------------------------------------------------
+        // 2. Building: copies the interface out of a module's tree. Subtrees are
+        // copied children first, like the parser creates them, so the copy keeps
+        // the Ast's invariants. Tokens are renumbered into the interface's table.
+        //------------------------------------------------------------------------------
+        class InterfaceBuilder {
+        public:
+            InterfaceBuilder(Ast& ast, const TokenStream& tokens, CompilationContext& context)
+                : ast_(ast), tokens_(tokens), context_(context) {}
+
+            void run() {
+                std::vector<NodeId> items;
+                const std::span<const NodeId> module = ast_.list(ast_[ast_.root()].lhs);
+                // A copy of the items: ParseBody() may grow the extra array under them.
+                for (NodeId item : std::vector<NodeId>(module.begin(), module.end())) {
+                    const NodeKind kind = ast_[item].kind;
+                    if (kind == NodeKind::Function || kind == NodeKind::Class || kind == NodeKind::Enum)
+                        items.push_back(copy(item, false));
+                }
+                root_ = add(Node{ NodeKind::Module, 0, 0, addList(items), InvalidNode });
+            }
+
+            std::string image(uint64_t sourceHash, uint64_t sourceSize,
+                const std::vector<std::pair<std::string, ModuleInterface::Dependency>>& dependencies) {
+                std::vector<ModuleInterface::Dependency> records;
+                for (const auto& [path, dependency] : dependencies) {
+                    ModuleInterface::Dependency record = dependency;
+                    record.path = static_cast<uint32_t>(strings_.size());
+                    record.pathLength = static_cast<uint32_t>(path.size());
+                    strings_.append(path);
+                    records.push_back(record);
+                }
+
+                Header header{};
+                std::memcpy(header.magic, Magic, sizeof(Magic));
+                header.format = FormatVersion;
+                header.endianMark = EndianMark;
+                header.versionSeed = VersionSeed();
+                header.sourceHash = sourceHash;
+                header.sourceSize = sourceSize;
+                header.dependencyCount = static_cast<uint32_t>(records.size());
+                header.nodeCount = static_cast<uint32_t>(nodes_.size());
+                header.extraCount = static_cast<uint32_t>(extra_.size());
+                header.tokenCount = static_cast<uint32_t>(tokenRecords_.size());
+                header.stringBytes = static_cast<uint32_t>(strings_.size());
+                header.root = root_;
+                const Layout layout = ComputeLayout(header);
+                header.bodySize = layout.end;
+
+                std::string image(sizeof(header) + layout.end, '\0');
+                char* body = image.data() + sizeof(header);
+                const auto put = [&](size_t at, const void* data, size_t size) {
+                    if (size)
+                        std::memcpy(body + at, data, size);
+                };
+                put(layout.dependencies, records.data(), records.size() * sizeof(ModuleInterface::Dependency));
+                put(layout.nodes, nodes_.data(), nodes_.size() * sizeof(Node));
+                put(layout.extra, extra_.data(), extra_.size() * sizeof(uint32_t));
+                put(layout.tokens, tokenRecords_.data(), tokenRecords_.size() * sizeof(ModuleInterface::TokenRecord));
+                put(layout.strings, strings_.data(), strings_.size());
+                header.bodyHash = Hash64(body, layout.end);
+                std::memcpy(image.data(), &header, sizeof(header));
+                return image;
+            }
+
+        private:
+            // `templated` is set inside generic functions and classes, whose bodies
+            // and field initializers the importer instantiates.
+            NodeId copy(NodeId id, bool templated) {
+                if (id == InvalidNode)
+                    return id;
+                // ParseBody() may grow the tree, so work on a copy of the node.
+                Node n = ast_[id];
+                switch (n.kind) {
+                case NodeKind::Module:
+                case NodeKind::Block:
+                case NodeKind::Import:
+                case NodeKind::NamedType:
+                case NodeKind::TupleType:
+                case NodeKind::Tuple:
+                case NodeKind::Array:
+                    n.lhs = copyList(n.lhs, templated);
+                    break;
+                case NodeKind::Function: {
+                    const FunctionData data = ast_.function(id);
+                    templated = templated || data.generics != EmptyList;
+                    const NodeId body = templated ? copy(ParseBody(ast_, tokens_, id, context_), true) : InvalidNode;
+                    const ListRef generics = copyList(data.generics, templated);
+                    const ListRef params = copyList(data.params, templated);
+                    const NodeId returnType = copy(data.returnType, templated);
+                    n.lhs = addRecord({ generics, params, returnType });
+                    n.rhs = body;
+                    break;
+                }
+                case NodeKind::Class: {
+                    const ClassData data = ast_.classData(id);
+                    templated = templated || data.generics != EmptyList;
+                    const ListRef generics = copyList(data.generics, templated);
+                    const NodeId base = copy(data.base, templated);
+                    const ListRef baseArguments = copyList(data.baseArguments, templated);
+                    n.rhs = copyList(n.rhs, templated);
+                    n.lhs = addRecord({ generics, base, baseArguments });
+                    break;
+                }
+                case NodeKind::Enum: {
+                    const EnumData data = ast_.enumeration(id);
+                    const ListRef generics = copyList(data.generics, templated);
+                    const NodeId underlying = copy(data.underlying, templated);
+                    n.rhs = copyList(n.rhs, templated);
+                    n.lhs = addRecord({ generics, underlying });
+                    break;
+                }
+                case NodeKind::VarDecl:
+                    n.lhs = copy(n.lhs, templated);
+                    n.rhs = templated ? copy(n.rhs, templated) : InvalidNode;
+                    break;
+                case NodeKind::Iter: {
+                    const IterData data = ast_.iter(id);
+                    const NodeId source = copy(data.source, templated);
+                    const ListRef bindings = copyList(data.bindings, templated);
+                    n.rhs = copy(n.rhs, templated);
+                    n.lhs = addRecord({ source, bindings });
+                    break;
+                }
+                case NodeKind::If: {
+                    const IfData data = ast_.branches(id);
+                    n.lhs = copy(n.lhs, templated);
+                    const NodeId then = copy(data.then, templated);
+                    const NodeId otherwise = copy(data.otherwise, templated);
+                    n.rhs = addRecord({ then, otherwise });
+                    break;
+                }
+                case NodeKind::Compare:
+                case NodeKind::Call:
+                    n.lhs = copy(n.lhs, templated);
+                    n.rhs = copyList(n.rhs, templated);
+                    break;
+                case NodeKind::LazyBody:
+                    // Bodies are parsed before they are copied.
+                    return InvalidNode;
+                default:
+                    n.lhs = copy(n.lhs, templated);
+                    n.rhs = copy(n.rhs, templated);
+                    break;
+                }
+                n.token = token(n.token);
+                return add(n);
+            }
+
+            ListRef copyList(ListRef ref, bool templated) {
+                // Not a range-for: copying may grow the extra array under the list.
+                std::vector<NodeId> ids;
+                ids.reserve(ast_.list(ref).size());
+                for (size_t i = 0; i < ast_.list(ref).size(); i++)
+                    ids.push_back(copy(ast_.list(ref)[i], templated));
+                return addList(ids);
+            }
+
+            // Equal lexemes are the same token kind, so nodes naming the same thing
+            // share one record.
+            uint32_t token(uint32_t index) {
+                const std::string_view lexeme = tokens_.lexeme(index);
+                auto [slot, added] = tokenIds_.try_emplace(lexeme, static_cast<uint32_t>(tokenRecords_.size()));
+                if (added) {
+                    tokenRecords_.push_back(ModuleInterface::TokenRecord{ tokens_.kind(index), {},
+                        static_cast<uint32_t>(strings_.size()), static_cast<uint32_t>(lexeme.size()) });
+                    strings_.append(lexeme);
+                }
+                return slot->second;
+            }
+
+            NodeId add(const Node& node) {
+                nodes_.push_back(node);
+                return static_cast<NodeId>(nodes_.size() - 1);
+            }
+
+            ListRef addList(const std::vector<NodeId>& ids) {
+                if (ids.empty())
+                    return EmptyList;
+                const ListRef ref = static_cast<ListRef>(extra_.size());
+                extra_.push_back(static_cast<uint32_t>(ids.size()));
+                extra_.insert(extra_.end(), ids.begin(), ids.end());
+                return ref;
+            }
+
+            uint32_t addRecord(std::initializer_list<uint32_t> fields) {
+                const uint32_t at = static_cast<uint32_t>(extra_.size());
+                extra_.insert(extra_.end(), fields);
+                return at;
+            }
+
+            Ast& ast_;
+            const TokenStream& tokens_;
+            CompilationContext& context_;
+            std::vector<Node> nodes_;
+            std::vector<uint32_t> extra_{ 0 };
+            std::vector<ModuleInterface::TokenRecord> tokenRecords_;
+            std::string strings_;
+            std::unordered_map<std::string_view, uint32_t> tokenIds_;   // Lexeme -> record.
+            NodeId root_{ InvalidNode };
+        };
+
+        // Written to a temporary file and renamed into place, so a concurrent
+        // compiler never maps a half-written interface.
+        bool WriteImage(const std::string& path, std::string_view image) {
+            const std::string temporary = path + "." + std::to_string(std::random_device{}()) + ".tmp";
+            std::FILE* stream = std::fopen(temporary.c_str(), "wb");
+            if (!stream)
+                return false;
+            bool written = std::fwrite(image.data(), 1, image.size(), stream) == image.size();
+            written = std::fclose(stream) == 0 && written;
+            std::error_code ec;
+            if (written)
+                std::filesystem::rename(temporary, path, ec);
+            if (!written || ec) {
+                std::filesystem::remove(temporary, ec);
+                return false;
+            }
+            return true;
+        }
+
+        //------------------------------------------------------------------------------
+        // 3. Importing. Each module's interface lists every source it was built from
+        // with the hash of its bytes, flattened over the import graph, so checking
+        // an interface hashes those sources and never parses anything.
+        //------------------------------------------------------------------------------
+        class Importer {
+        public:
+            // The file being compiled is the first active module, so a cycle back
+            // to it is seen as one.
+            Importer(std::string importer, CompilationContext& context)
+                : context_(context), active_{ std::move(importer) } {}
+
+            bool import(const std::string& path, ModuleInterface& out, std::string& error) {
+                SourceFile file;
+                if (!SourceFile::Open(path, file, error)) {
+                    error = "cannot open module '" + path + "': " + error;
+                    return false;
+                }
+                const uint64_t hash = Hash64(file.getText());
+                const std::string interfacePath = InterfacePath(path);
+                SourceFile image;
+                std::string ignored;
+                if (SourceFile::Open(interfacePath, image, ignored) && ModuleInterface::Open(std::move(image), out)
+                    && out.sourceHash() == hash && out.sourceSize() == file.size() && dependenciesCurrent(interfacePath, out))
+                    return true;
+
+                active_.push_back(path);
+                const bool built = build(path, std::move(file), hash, out, error);
+                active_.pop_back();
+                return built;
+            }
+
+        private:
+            using Dependencies = std::vector<std::pair<std::string, ModuleInterface::Dependency>>;
+
+            static std::filesystem::path Directory(const std::string& path) {
+                return std::filesystem::path(path).parent_path();
+            }
+
+            bool dependenciesCurrent(const std::string& interfacePath, const ModuleInterface& module) const {
+                const std::filesystem::path directory = Directory(interfacePath);
+                for (const ModuleInterface::Dependency& dependency : module.dependencies()) {
+                    SourceFile source;
+                    std::string ignored;
+                    const std::string path = (directory / module.path(dependency)).lexically_normal().string();
+                    if (!SourceFile::Open(path, source, ignored) || source.size() != dependency.size
+                        || Hash64(source.getText()) != dependency.hash)
+                        return false;
+                }
+                return true;
+            }
+
+            // Records `path` once, by its path from the current module's directory.
+            static void AddDependency(Dependencies& dependencies, const std::string& path, uint64_t hash, uint64_t size) {
+                for (const auto& entry : dependencies) {
+                    if (entry.first == path)
+                        return;
+                }
+                dependencies.push_back({ path, ModuleInterface::Dependency{ hash, size, 0, 0 } });
+            }
+
+            bool build(const std::string& path, SourceFile file, uint64_t hash, ModuleInterface& out, std::string& error) {
+                const uint64_t size = file.size();
+                CompilationUnit unit(path, std::move(file));
+                const TokenStream tokens = Tokenize(unit);
+                Ast ast = Parse(tokens, context_, BodyParsing::Lazy);
+                if (!report(unit, tokens.diagnostics(), error) || !report(unit, ast.diagnostics(), error))
+                    return false;
+
+                // The imported modules, and everything they were built from.
+                Dependencies dependencies;
+                for (NodeId item : ast.list(ast[ast.root()].lhs)) {
+                    if (ast[item].kind != NodeKind::Import || tokens.kind(ast[item].token) != TokenType::StringLiteral)
+                        continue;
+                    const std::string child = ResolveImport(path, tokens.getLiteral<std::string_view>(ast[item].token).value_or(""));
+                    if (std::find(active_.begin(), active_.end(), child) != active_.end()) {
+                        // An import cycle: the module is being built further up.
+                        SourceFile source;
+                        if (!SourceFile::Open(child, source, error))
+                            return false;
+                        AddDependency(dependencies, child, Hash64(source.getText()), source.size());
+                        continue;
+                    }
+                    ModuleInterface module;
+                    if (!import(child, module, error))
+                        return false;
+                    AddDependency(dependencies, child, module.sourceHash(), module.sourceSize());
+                    const std::filesystem::path directory = Directory(InterfacePath(child));
+                    for (const ModuleInterface::Dependency& dependency : module.dependencies()) {
+                        const std::string transitive = (directory / module.path(dependency)).lexically_normal().string();
+                        if (transitive != path)
+                            AddDependency(dependencies, transitive, dependency.hash, dependency.size);
+                    }
+                }
+
+                InterfaceBuilder builder(ast, tokens, context_);
+                builder.run();
+                // Generic bodies are only parsed now.
+                if (!report(unit, ast.diagnostics(), error))
+                    return false;
+
+                const std::string interfacePath = InterfacePath(path);
+                const std::filesystem::path directory = Directory(interfacePath);
+                for (auto& entry : dependencies)
+                    entry.first = std::filesystem::path(entry.first).lexically_relative(directory.empty() ? "." : directory).string();
+                const std::string image = builder.image(hash, size, dependencies);
+
+                // A read-only directory only costs the rebuild next time.
+                SourceFile mapped;
+                std::string ignored;
+                if (WriteImage(interfacePath, image) && SourceFile::Open(interfacePath, mapped, ignored)
+                    && ModuleInterface::Open(std::move(mapped), out))
+                    return true;
+                if (ModuleInterface::Open(SourceFile::FromString(image), out))
+                    return true;
+                error = "could not build the interface of '" + path + "'";
+                return false;
+            }
+
+            static bool report(const CompilationUnit& unit, const std::vector<Diagnostic>& diagnostics, std::string& error) {
+                for (const Diagnostic& diagnostic : diagnostics) {
+                    if (diagnostic.severity == Diagnostic::Severity::Error) {
+                        error = FormatDiagnostic(unit, diagnostic);
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            CompilationContext& context_;
+            std::vector<std::string> active_;   // The compiled file, then the modules being built, importer first.
+        };
+
+    } // namespace
+
+    //------------------------------------------------------------------------------
+    // 4. Views. The header, the body hash and then every index are checked, so a
+    // damaged or forged file is rejected here and rebuilt, never read out of bounds.
+    //------------------------------------------------------------------------------
+    bool ModuleInterface::Open(SourceFile image, ModuleInterface& out) {
+        const std::string_view bytes = image.getText();
+        Header header;
+        if (bytes.size() < sizeof(header))
+            return false;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.format != FormatVersion
+            || header.endianMark != EndianMark || header.versionSeed != VersionSeed())
+            return false;
+
+        const std::string_view body = bytes.substr(sizeof(header));
+        const Layout layout = ComputeLayout(header);
+        if (header.bodySize != body.size() || layout.end != body.size() || header.extraCount == 0
+            || header.root >= header.nodeCount || Hash64(body) != header.bodyHash)
+            return false;
+
+        ModuleInterface view;
+        view.dependencies_ = Section<Dependency>(body, layout.dependencies, header.dependencyCount);
+        view.nodes_ = Section<Node>(body, layout.nodes, header.nodeCount);
+        view.extra_ = Section<uint32_t>(body, layout.extra, header.extraCount);
+        view.tokens_ = Section<TokenRecord>(body, layout.tokens, header.tokenCount);
+        view.strings_ = body.substr(layout.strings, header.stringBytes);
+        view.root_ = header.root;
+
+        for (const Dependency& dependency : view.dependencies_) {
+            if (!ValidRef(dependency.path, dependency.pathLength, header.stringBytes))
+                return false;
+        }
+        for (const TokenRecord& token : view.tokens_) {
+            if (static_cast<size_t>(token.kind) >= TokenTypeCount || !ValidRef(token.text, token.length, header.stringBytes))
+                return false;
+        }
+        if (view.nodes_[view.root_].kind != NodeKind::Module || !TreeChecker(view.nodes_, view.extra_, header.tokenCount).run())
+            return false;
+
+        view.sourceHash_ = header.sourceHash;
+        view.sourceSize_ = header.sourceSize;
+        // The views point into the mapping, which keeps its address when moved.
+        view.image_ = std::move(image);
+        out = std::move(view);
+        return true;
+    }
+
+    //------------------------------------------------------------------------------
+    // 5. Paths and the Entry Point
+    //------------------------------------------------------------------------------
+    std::string ResolveImport(std::string_view importer, std::string_view name) {
+        std::filesystem::path path = std::filesystem::path(importer).parent_path() / std::filesystem::path(name);
+        if (!path.has_extension())
+            path += ".gem";
+        return path.lexically_normal().string();
+    }
+
+    std::string InterfacePath(std::string_view path) {
+        return std::filesystem::path(path).replace_extension(".gemi").string();
+    }
+
+    bool ImportModule(const std::string& path, const std::string& importer, ModuleInterface& out, std::string& error,
+        CompilationContext& context) {
+        return Importer(std::filesystem::path(importer).lexically_normal().string(), context)
+            .import(std::filesystem::path(path).lexically_normal().string(), out, error);
+    }
+
+} // namespace GC
@@ -0,0 +1,200 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "../Unit/Diagnostic.h"
+
+namespace GC {
+
+    class TokenStream;
+
+    //------------------------------------------------------------------------------
+    // 1. Node Ids and Lists
+    //
+    // Nodes are addressed by 32-bit indices into the Ast's node pool. Variable-length
+    // children (the statements of a block, the arguments of a call, ...) live in the
+    // Ast's extra array as a count followed by the node ids; a list is referred to
+    // by the index of its count. Children are always created before their parent,
+    // so the root is the last node of the pool, followed only by function bodies
+    // parsed later by ParseBody() (Parser.h).
+    //------------------------------------------------------------------------------
+    using NodeId = uint32_t;
+    using ListRef = uint32_t;
+
+    inline constexpr NodeId InvalidNode = UINT32_MAX;
+    inline constexpr ListRef EmptyList = 0;
+
+    //------------------------------------------------------------------------------
+    // 2. Node Kinds
+    //
+    // Every node records the token it is anchored at; names, literals and operators
+    // are read back from that token, so the tree holds no strings. The meaning of
+    // lhs and rhs per kind:
+    //------------------------------------------------------------------------------
+    enum class NodeKind : uint8_t {
+        // Items and statements
+        Module,         // lhs: list of items.
+        Block,          // token '['; lhs: list of statements.
+        LazyBody,       // token '['; lhs: token of the matching ']'. A function body not parsed yet.
+        Import,         // token: the "file" string or the dependency name; lhs: list of imported Names.
+        VarDecl,        // token: name; lhs: type; rhs: initializer or InvalidNode.
+        Function,       // token: name; lhs: FunctionData record; rhs: body Block or LazyBody, InvalidNode if abstract.
+        Param,          // token: name; lhs: type; rhs: Name of the member it initializes, or InvalidNode.
+        GenericParam,   // token: name; lhs: constraint type or InvalidNode.
+        Class,          // token: name; lhs: ClassData record; rhs: list of members.
+        Access,         // token 'public' or 'private': the members that follow have that access.
+        Enum,           // token: name, or 'enum' when anonymous; lhs: EnumData record; rhs: list of EnumMembers.
+        EnumMember,     // token: name; lhs: payload type or InvalidNode; rhs: value or InvalidNode.
+        Iter,           // token 'iter'; lhs: IterData record; rhs: body.
+        While,          // token 'while'; lhs: condition; rhs: body.
+        If,             // token 'if'; lhs: condition; rhs: IfData record.
+        Compare,        // token 'compare'; lhs: compared value; rhs: list of On and Default cases.
+        On,             // token 'on'; lhs: value; rhs: body.
+        Default,        // token 'default'; rhs: body.
+        Return,         // token '->'; lhs: value or InvalidNode.
+        Exit,           // token 'exitProgram'; lhs: exit code.
+        Destroy,        // token 'destroy'; lhs: operand.
+        Delete,         // token 'delete'; lhs: operand.
+        Break,
+        Continue,
+
+        // Types
+        BuiltinType,    // token: the type keyword.
+        NamedType,      // token: name; lhs: list of type arguments.
+        PointerType,    // token '*'; lhs: pointee.
+        VecType,        // token 'vec'; lhs: element type.
+        TupleType,      // token 'tuple'; lhs: list of element types.
+        RepeatType,     // token '*'; lhs: element type; rhs: count Literal (`u32 * 3` in a tuple).
+
+        // Expressions
+        Literal,        // token: the literal.
+        Name,           // token: identifier, 'self' or 'vec'.
+        Unary,          // token: operator; lhs: operand.
+        Binary,         // token: operator; lhs, rhs: operands.
+        Assign,         // token '='; lhs: target; rhs: value.
+        Call,           // token '('; lhs: callee; rhs: list of arguments.
+        Index,          // token '['; lhs: indexed value; rhs: index.
+        Member,         // token: member name or tuple position; lhs: object.
+        Scope,          // token: name after '::'; lhs: scope.
+        Tuple,          // token '('; lhs: list of elements.
+        Array,          // token '['; lhs: list of elements.
+    };
+
+    std::string_view NodeKindName(NodeKind kind) noexcept;
+
+    struct Node {
+        enum Flags : uint16_t {
+            Const = 1 << 0,         // VarDecl, Param: declared with '@'.
+            Abstract = 1 << 1,      // Function: '@#name', no body.
+        };
+
+        NodeKind kind;
+        uint16_t flags;
+        uint32_t token;
+        uint32_t lhs;
+        uint32_t rhs;
+    };
+
+    static_assert(sizeof(Node) == 16, "Node must stay within 16 bytes");
+
+    // Records: nodes with more than two children keep the rest in the extra array.
+    struct FunctionData {
+        ListRef generics;       // GenericParams.
+        ListRef params;         // Params.
+        NodeId returnType;      // InvalidNode if none.
+    };
+
+    struct ClassData {
+        ListRef generics;       // GenericParams.
+        NodeId base;            // Type after '<->', or InvalidNode.
+        ListRef baseArguments;  // Types passed to the base class.
+    };
+
+    struct EnumData {
+        ListRef generics;       // GenericParams.
+        NodeId underlying;      // Type in parentheses, or InvalidNode.
+    };
+
+    struct IterData {
+        NodeId source;
+        ListRef bindings;       // Names; more than one when destructuring a tuple.
+    };
+
+    struct IfData {
+        NodeId then;
+        NodeId otherwise;       // Block, If (for 'else if'), or InvalidNode.
+    };
+
+    //------------------------------------------------------------------------------
+    // 3. The Ast
+    //
+    // A flat pool of nodes plus the extra array. The pool is the arena: nodes are
+    // never freed one by one, a traversal walks contiguous memory, and dropping the
+    // tree releases two allocations whatever its size. Token indices refer to the
+    // TokenStream the tree was parsed from, which has to outlive it.
+    //------------------------------------------------------------------------------
+    class Ast {
+    public:
+        Ast() : extra_{ 0 } {}
+
+        NodeId root() const noexcept { return root_; }
+        size_t size() const noexcept { return nodes_.size(); }
+        const Node& operator[](NodeId id) const noexcept { return nodes_[id]; }
+        const std::vector<Node>& nodes() const noexcept { return nodes_; }
+
+        std::span<const NodeId> list(ListRef ref) const noexcept {
+            return std::span<const NodeId>(extra_.data() + ref + 1, extra_[ref]);
+        }
+
+        FunctionData function(NodeId id) const noexcept {
+            const uint32_t* record = extra_.data() + nodes_[id].lhs;
+            return FunctionData{ record[0], record[1], record[2] };
+        }
+        ClassData classData(NodeId id) const noexcept {
+            const uint32_t* record = extra_.data() + nodes_[id].lhs;
+            return ClassData{ record[0], record[1], record[2] };
+        }
+        EnumData enumeration(NodeId id) const noexcept {
+            const uint32_t* record = extra_.data() + nodes_[id].lhs;
+            return EnumData{ record[0], record[1] };
+        }
+        IterData iter(NodeId id) const noexcept {
+            const uint32_t* record = extra_.data() + nodes_[id].lhs;
+            return IterData{ record[0], record[1] };
+        }
+        IfData branches(NodeId id) const noexcept {
+            const uint32_t* record = extra_.data() + nodes_[id].rhs;
+            return IfData{ record[0], record[1] };
+        }
+
+        // Syntax errors, in source order. The tree is still complete around them:
+        // statements that failed to parse are left out. Errors in a lazy body are
+        // only found when ParseBody() parses it.
+        const std::vector<Diagnostic>& diagnostics() const noexcept { return diagnostics_; }
+
+        // Joins trees parsed from consecutive token ranges of one stream, in order,
+        // into the tree of the whole range: the items of every part's module, then
+        // one module root. Each part's nodes are copied once with their ids and
+        // list references shifted, so merging is linear in the total size.
+        static Ast Concatenate(const std::vector<Ast>& parts);
+
+        // Bytes held by the node pool and the extra array.
+        size_t memoryUsage() const noexcept {
+            return nodes_.capacity() * sizeof(Node) + extra_.capacity() * sizeof(uint32_t);
+        }
+
+    private:
+        friend class Parser;
+
+        std::vector<Node> nodes_;
+        std::vector<uint32_t> extra_;   // Lists and records; extra_[0] is the empty list.
+        NodeId root_{ InvalidNode };
+        std::vector<Diagnostic> diagnostics_;
+    };
+
+    // Debug aid (--dump-ast): the tree as an indented outline, one node per line.
+    std::string FormatAst(const Ast& ast, const TokenStream& tokens);
+
+} // namespace GC
@@ -0,0 +1,148 @@
+#pragma once
+#include <initializer_list>
+#include <string_view>
+#include <vector>
+
+#include "Ast.h"
+#include "../Token/Token.h"
+#include "../Unit/CompilationContext.h"
+
+namespace GC {
+
+    class ThreadPool;
+
+    //------------------------------------------------------------------------------
+    // The Parser
+    //
+    // Recursive descent over a TokenStream for the grammar shown in
+    // GemFiles/doc.gem, with expressions parsed by binding power (Precedence.h).
+    // The language has no statement terminators: a statement ends
+    // where the next token cannot continue it. Declarations are told apart from
+    // expression statements by their leading type (a type keyword, '@', `Name Name`,
+    // `Name* Name` or `Name<...> Name`).
+    //
+    // After a syntax error the parser reports it, skips to the next token that can
+    // start a statement and carries on, so one run reports every broken statement.
+    // Error messages are stored in the CompilationContext's arena.
+    //
+    // With BodyParsing::Lazy a function body is not parsed: the parser jumps from
+    // its `[` to the matching `]`, which the lexer already linked, and leaves a
+    // LazyBody node. ParseBody() parses it once something needs the statements,
+    // so the functions of an imported module that a program never calls cost one
+    // node each.
+    //------------------------------------------------------------------------------
+    enum class BodyParsing : uint8_t {
+        Eager,
+        Lazy,
+    };
+
+    class Parser {
+    public:
+        // Deepest expression nesting accepted before reporting an error.
+        static constexpr uint32_t MaxExpressionDepth = 256;
+        // Deepest nesting of blocks, classes, `else if` chains and types accepted
+        // before reporting an error.
+        static constexpr uint32_t MaxNestingDepth = 256;
+
+        explicit Parser(const TokenStream& tokens, CompilationContext& context = CompilationContext::Global(),
+            BodyParsing bodies = BodyParsing::Eager);
+
+        // Parses only tokens [begin, end), as if the stream ended there. Node tokens
+        // still index the whole stream.
+        Parser(const TokenStream& tokens, CompilationContext& context, size_t begin, size_t end,
+            BodyParsing bodies = BodyParsing::Eager);
+
+        Parser(const Parser&) = delete;
+        Parser& operator=(const Parser&) = delete;
+
+        Ast parse();
+
+        // Parses the block at the start of the range into `ast`, which was parsed
+        // from the same stream, and makes it the body of `function`.
+        NodeId parseBody(Ast& ast, NodeId function);
+
+    private:
+        // Statements
+        void parseStatements(TokenType end, bool inClass);
+        bool parseStatement(bool inClass);
+        bool parseDeclarations();
+        NodeId parseImport();
+        NodeId parseFunctionOrClass(uint16_t flags);
+        NodeId parseFunction(uint32_t name, ListRef generics, uint16_t flags);
+        NodeId parseClass(uint32_t name, ListRef generics);
+        NodeId parseParam();
+        bool parseGenericParams(ListRef& out);
+        NodeId parseEnum();
+        NodeId parseEnumMember();
+        NodeId parseIter();
+        NodeId parseWhile();
+        NodeId parseIf();
+        NodeId parseCompare();
+        NodeId parseBlock();
+        NodeId skipBlock();
+        NodeId parseCondition(std::string_view construct);
+        bool looksLikeDeclaration() const;
+        void synchronize(TokenType end, size_t start);
+        bool nestedTooDeeply(std::string_view construct);
+
+        // Types
+        NodeId parseType();
+        bool parseTypeArguments(TokenType close, ListRef& out);
+
+        // Expressions: operators bind their operands by the binding powers of
+        // Precedence.h. `minPower` is that of the operator left of the expression.
+        NodeId parseExpression(uint8_t minPower = 0);
+        NodeId parseOperand();
+        NodeId parsePostfix(NodeId value, NodeKind kind);
+        NodeId parsePrimary();
+        bool parseExpressionList(TokenType close, ListRef& out, size_t begin);
+
+        // Tokens
+        TokenType peek(size_t k = 0) const noexcept {
+            size_t i = position_ + k;
+            return i < end_ ? kinds_[i] : TokenType::EndOfFile;
+        }
+        bool at(TokenType type) const noexcept { return peek() == type; }
+        uint32_t advance() noexcept { return static_cast<uint32_t>(position_ < end_ ? position_++ : position_); }
+        bool match(TokenType type) noexcept;
+        bool expect(TokenType type, std::string_view context);
+        void error(std::string_view message);
+
+        // Nodes
+        NodeId add(NodeKind kind, uint32_t token, uint32_t lhs = InvalidNode, uint32_t rhs = InvalidNode, uint16_t flags = 0);
+        ListRef addList(size_t scratchBegin);
+        uint32_t addRecord(std::initializer_list<uint32_t> fields);
+
+        const TokenStream& tokens_;
+        const TokenType* kinds_;
+        size_t count_;
+        size_t end_;                    // End of the parsed range: the EndOfFile token by default.
+        size_t position_;
+        CompilationContext& context_;
+        Ast ast_;
+        std::vector<NodeId> scratch_;   // Children of the lists being built, innermost last.
+        uint32_t expressionDepth_{ 0 };
+        uint32_t nestingDepth_{ 0 };    // Blocks, classes, `else if` chains and types being parsed.
+        BodyParsing bodies_;
+    };
+
+    // Convenience function: parses a whole token stream.
+    Ast Parse(const TokenStream& tokens, CompilationContext& context = CompilationContext::Global(),
+        BodyParsing bodies = BodyParsing::Eager);
+
+    // The body of `function`, parsing it first if it is still a LazyBody. Returns
+    // InvalidNode for an abstract function. Syntax errors in the body join the
+    // tree's diagnostics.
+    NodeId ParseBody(Ast& ast, const TokenStream& tokens, NodeId function,
+        CompilationContext& context = CompilationContext::Global());
+
+    // Parallel variant: top-level declarations are parsed on the pool (see
+    // ParallelParse.cpp). For a source without syntax errors the tree is the
+    // serial parser's, node for node.
+    Ast Parse(const TokenStream& tokens, ThreadPool& pool, CompilationContext& context = CompilationContext::Global());
+
+    // Token indices at which the parallel parser may split the stream: the start
+    // of every top-level #function, #class and enum, and the token after its body.
+    std::vector<uint32_t> TopLevelBoundaries(const TokenStream& tokens);
+
+} // namespace GC
@@ -0,0 +1,117 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+#include "Ast.h"
+#include "../Token/Token.h"
+
+namespace GC {
+
+    //------------------------------------------------------------------------------
+    // 1. Operator Precedence
+    //
+    // Everything the expression parser knows about operators. Binding powers grow
+    // with precedence. An infix operator binds `left` to the expression before it
+    // and parses the expression after it at `right`, so `right > left` makes it
+    // left-associative and `right < left` right-associative. Prefix operators
+    // parse their operand at `right`; postfix operators (calls, indexing, member
+    // access, `::`) bind `left` to the expression before them. Adding an operator
+    // is one row here, after its spelling in TokenSpellings (Token.h).
+    //------------------------------------------------------------------------------
+    namespace Precedence {
+
+        enum class Form : uint8_t {
+            Prefix,
+            Infix,
+            Postfix
+        };
+
+        // Prefix and postfix operators bind tighter than every infix operator.
+        inline constexpr uint8_t PrefixPower = 17;
+        inline constexpr uint8_t PostfixPower = 19;
+
+        struct Row {
+            TokenType type;
+            Form form;
+            uint8_t left;
+            uint8_t right;
+            NodeKind kind;      // Node built for the operator.
+        };
+
+        inline constexpr Row Rows[] = {
+            { TokenType::Assign,       Form::Infix,   2,  1,  NodeKind::Assign },
+            { TokenType::Or,           Form::Infix,   3,  4,  NodeKind::Binary },
+            { TokenType::And,          Form::Infix,   5,  6,  NodeKind::Binary },
+            { TokenType::Equal,        Form::Infix,   7,  8,  NodeKind::Binary },
+            { TokenType::NotEqual,     Form::Infix,   7,  8,  NodeKind::Binary },
+            { TokenType::Less,         Form::Infix,   9,  10, NodeKind::Binary },
+            { TokenType::LessEqual,    Form::Infix,   9,  10, NodeKind::Binary },
+            { TokenType::Greater,      Form::Infix,   9,  10, NodeKind::Binary },
+            { TokenType::GreaterEqual, Form::Infix,   9,  10, NodeKind::Binary },
+            { TokenType::Range,        Form::Infix,   11, 12, NodeKind::Binary },
+            { TokenType::Plus,         Form::Infix,   13, 14, NodeKind::Binary },
+            { TokenType::Minus,        Form::Infix,   13, 14, NodeKind::Binary },
+            { TokenType::Multiply,     Form::Infix,   15, 16, NodeKind::Binary },
+            { TokenType::Divide,       Form::Infix,   15, 16, NodeKind::Binary },
+            { TokenType::Modulo,       Form::Infix,   15, 16, NodeKind::Binary },
+            { TokenType::Minus,        Form::Prefix,  0,  PrefixPower, NodeKind::Unary },
+            { TokenType::Not,          Form::Prefix,  0,  PrefixPower, NodeKind::Unary },
+            { TokenType::Ampersand,    Form::Prefix,  0,  PrefixPower, NodeKind::Unary },    // Mutable reference.
+            { TokenType::AmpersandAt,  Form::Prefix,  0,  PrefixPower, NodeKind::Unary },    // Immutable reference.
+            { TokenType::LeftParen,    Form::Postfix, PostfixPower, 0,  NodeKind::Call },
+            { TokenType::LeftBracket,  Form::Postfix, PostfixPower, 0,  NodeKind::Index },
+            { TokenType::Dot,          Form::Postfix, PostfixPower, 0,  NodeKind::Member },
+            { TokenType::DoubleColon,  Form::Postfix, PostfixPower, 0,  NodeKind::Scope },
+        };
+
+        //------------------------------------------------------------------------------
+        // 2. Lookup Tables
+        //
+        // One entry per TokenType and form, so the parser's operator test is a
+        // single load. `left` and `right` are both 0 where the token is not an
+        // operator of that form.
+        //------------------------------------------------------------------------------
+        struct BindingPower {
+            uint8_t left{ 0 };
+            uint8_t right{ 0 };
+            NodeKind kind{ NodeKind::Binary };
+
+            constexpr bool isOperator() const noexcept { return left != 0 || right != 0; }
+        };
+
+        using Table = std::array<BindingPower, TokenTypeCount>;
+
+        constexpr Table Build(Form form) {
+            Table table{};
+            for (const Row& row : Rows) {
+                if (row.form == form)
+                    table[static_cast<size_t>(row.type)] = BindingPower{ row.left, row.right, row.kind };
+            }
+            return table;
+        }
+
+        inline constexpr Table PrefixTable = Build(Form::Prefix);
+        inline constexpr Table InfixTable = Build(Form::Infix);
+        inline constexpr Table PostfixTable = Build(Form::Postfix);
+
+        static_assert([] {
+            for (size_t i = 0; i < std::size(Rows); i++) {
+                for (size_t j = i + 1; j < std::size(Rows); j++) {
+                    if (Rows[i].type == Rows[j].type && Rows[i].form == Rows[j].form)
+                        return false;
+                }
+                // 0 is reserved for "not an operator".
+                if (Rows[i].form == Form::Infix && (Rows[i].left == 0 || Rows[i].right == 0
+                    || Rows[i].left >= PrefixPower || Rows[i].right >= PrefixPower))
+                    return false;
+            }
+            return true;
+        }(), "Each operator needs one row per form, and infix powers must stay below PrefixPower");
+
+        constexpr BindingPower Prefix(TokenType type) noexcept { return PrefixTable[static_cast<size_t>(type)]; }
+        constexpr BindingPower Infix(TokenType type) noexcept { return InfixTable[static_cast<size_t>(type)]; }
+        constexpr BindingPower Postfix(TokenType type) noexcept { return PostfixTable[static_cast<size_t>(type)]; }
+
+    } // namespace Precedence
+
+} // namespace GC
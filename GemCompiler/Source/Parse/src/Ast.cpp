@@ -0,0 +1,255 @@
+#include "../Ast.h"
+
+#include "../../Token/Token.h"
+
+namespace GC {
+
+    std::string_view NodeKindName(NodeKind kind) noexcept {
+        static constexpr std::string_view Names[] = {
+            "Module", "Block", "LazyBody", "Import", "VarDecl", "Function", "Param", "GenericParam", "Class", "Access",
+            "Enum", "EnumMember", "Iter", "While", "If", "Compare", "On", "Default", "Return", "Exit",
+            "Destroy", "Delete", "Break", "Continue",
+            "BuiltinType", "NamedType", "PointerType", "VecType", "TupleType", "RepeatType",
+            "Literal", "Name", "Unary", "Binary", "Assign", "Call", "Index", "Member", "Scope", "Tuple", "Array",
+        };
+        static_assert(std::size(Names) == static_cast<size_t>(NodeKind::Array) + 1, "Every node kind needs a name");
+        return Names[static_cast<size_t>(kind)];
+    }
+
+    //------------------------------------------------------------------------------
+    // Concatenate: node ids move by the number of nodes before the part, and list
+    // and record indices by the extra words before it (each part's shared empty
+    // list at extra_[0] is dropped). Every list and record belongs to exactly one
+    // node, so relocating node by node touches each of them once.
+    //------------------------------------------------------------------------------
+    Ast Ast::Concatenate(const std::vector<Ast>& parts) {
+        Ast whole;
+        size_t nodeCount = 1, extraCount = 1, itemCount = 0;
+        for (const Ast& part : parts) {
+            nodeCount += part.nodes_.size();
+            extraCount += part.extra_.size();
+            if (part.root_ != InvalidNode)
+                itemCount += part.list(part[part.root_].lhs).size();
+        }
+        whole.nodes_.reserve(nodeCount);
+        whole.extra_.reserve(extraCount + itemCount + 1);
+
+        std::vector<NodeId> items;
+        items.reserve(itemCount);
+        for (const Ast& part : parts) {
+            if (part.root_ == InvalidNode)
+                continue;
+            const uint32_t nodeBase = static_cast<uint32_t>(whole.nodes_.size());
+            const uint32_t extraBase = static_cast<uint32_t>(whole.extra_.size()) - 1;
+            std::vector<uint32_t>& extra = whole.extra_;
+
+            const auto node = [&](uint32_t id) { return id == InvalidNode ? id : id + nodeBase; };
+            const auto list = [&](ListRef ref) {
+                if (ref == EmptyList)
+                    return ref;
+                ref += extraBase;
+                for (uint32_t i = 1; i <= extra[ref]; i++)
+                    extra[ref + i] += nodeBase;
+                return ref;
+            };
+
+            // The part's root module is not copied; its items are.
+            whole.nodes_.insert(whole.nodes_.end(), part.nodes_.begin(), part.nodes_.begin() + part.root_);
+            extra.insert(extra.end(), part.extra_.begin() + 1, part.extra_.end());
+            for (NodeId item : part.list(part[part.root_].lhs))
+                items.push_back(item + nodeBase);
+
+            for (size_t i = nodeBase; i < whole.nodes_.size(); i++) {
+                Node& n = whole.nodes_[i];
+                switch (n.kind) {
+                case NodeKind::Module:
+                case NodeKind::Block:
+                case NodeKind::Import:
+                case NodeKind::NamedType:
+                case NodeKind::TupleType:
+                case NodeKind::Tuple:
+                case NodeKind::Array:
+                    n.lhs = list(n.lhs);
+                    break;
+                case NodeKind::Function: {
+                    n.lhs += extraBase;
+                    uint32_t* record = extra.data() + n.lhs;
+                    record[0] = list(record[0]);
+                    record[1] = list(record[1]);
+                    record[2] = node(record[2]);
+                    n.rhs = node(n.rhs);
+                    break;
+                }
+                case NodeKind::Class: {
+                    n.lhs += extraBase;
+                    uint32_t* record = extra.data() + n.lhs;
+                    record[0] = list(record[0]);
+                    record[1] = node(record[1]);
+                    record[2] = list(record[2]);
+                    n.rhs = list(n.rhs);
+                    break;
+                }
+                case NodeKind::Enum: {
+                    n.lhs += extraBase;
+                    uint32_t* record = extra.data() + n.lhs;
+                    record[0] = list(record[0]);
+                    record[1] = node(record[1]);
+                    n.rhs = list(n.rhs);
+                    break;
+                }
+                case NodeKind::Iter: {
+                    n.lhs += extraBase;
+                    uint32_t* record = extra.data() + n.lhs;
+                    record[0] = node(record[0]);
+                    record[1] = list(record[1]);
+                    n.rhs = node(n.rhs);
+                    break;
+                }
+                case NodeKind::If: {
+                    n.lhs = node(n.lhs);
+                    n.rhs += extraBase;
+                    uint32_t* record = extra.data() + n.rhs;
+                    record[0] = node(record[0]);
+                    record[1] = node(record[1]);
+                    break;
+                }
+                case NodeKind::Compare:
+                case NodeKind::Call:
+                    n.lhs = node(n.lhs);
+                    n.rhs = list(n.rhs);
+                    break;
+                case NodeKind::LazyBody:
+                    break;
+                default:
+                    n.lhs = node(n.lhs);
+                    n.rhs = node(n.rhs);
+                    break;
+                }
+            }
+            whole.diagnostics_.insert(whole.diagnostics_.end(), part.diagnostics_.begin(), part.diagnostics_.end());
+        }
+
+        ListRef module = EmptyList;
+        if (!items.empty()) {
+            module = static_cast<ListRef>(whole.extra_.size());
+            whole.extra_.push_back(static_cast<uint32_t>(items.size()));
+            whole.extra_.insert(whole.extra_.end(), items.begin(), items.end());
+        }
+        whole.nodes_.push_back(Node{ NodeKind::Module, 0, 0, module, InvalidNode });
+        whole.root_ = static_cast<NodeId>(whole.nodes_.size() - 1);
+        return whole;
+    }
+
+    namespace {
+
+        //------------------------------------------------------------------------------
+        // Outline printer: "Kind 'token'" per node, children indented below it and
+        // labelled where the role is not obvious from the kind.
+        //------------------------------------------------------------------------------
+        class AstPrinter {
+        public:
+            AstPrinter(const Ast& ast, const TokenStream& tokens) : ast_(ast), tokens_(tokens) {}
+
+            std::string run() {
+                if (ast_.root() != InvalidNode)
+                    node(ast_.root(), 0, {});
+                return std::move(out_);
+            }
+
+        private:
+            void node(NodeId id, int depth, std::string_view label) {
+                if (id == InvalidNode)
+                    return;
+                const Node& n = ast_[id];
+                out_.append(static_cast<size_t>(depth) * 2, ' ');
+                if (!label.empty())
+                    out_.append(label).append(": ");
+                out_.append(NodeKindName(n.kind));
+                if (n.kind != NodeKind::Module) {
+                    out_.append(" '").append(tokens_.lexeme(n.token)).append("'");
+                }
+                if (n.flags & Node::Const)
+                    out_.append(" const");
+                if (n.flags & Node::Abstract)
+                    out_.append(" abstract");
+                out_.append("\n");
+
+                depth++;
+                switch (n.kind) {
+                case NodeKind::Module:
+                case NodeKind::Block:
+                case NodeKind::Import:
+                case NodeKind::NamedType:
+                case NodeKind::TupleType:
+                case NodeKind::Tuple:
+                case NodeKind::Array:
+                    list(n.lhs, depth, {});
+                    break;
+                case NodeKind::Function: {
+                    FunctionData data = ast_.function(id);
+                    list(data.generics, depth, "generic");
+                    list(data.params, depth, "param");
+                    node(data.returnType, depth, "returns");
+                    node(n.rhs, depth, "body");
+                    break;
+                }
+                case NodeKind::Class: {
+                    ClassData data = ast_.classData(id);
+                    list(data.generics, depth, "generic");
+                    node(data.base, depth, "base");
+                    list(data.baseArguments, depth, "base argument");
+                    list(n.rhs, depth, {});
+                    break;
+                }
+                case NodeKind::Enum: {
+                    EnumData data = ast_.enumeration(id);
+                    list(data.generics, depth, "generic");
+                    node(data.underlying, depth, "underlying");
+                    list(n.rhs, depth, {});
+                    break;
+                }
+                case NodeKind::Iter: {
+                    IterData data = ast_.iter(id);
+                    node(data.source, depth, "source");
+                    list(data.bindings, depth, "binding");
+                    node(n.rhs, depth, "body");
+                    break;
+                }
+                case NodeKind::If: {
+                    IfData data = ast_.branches(id);
+                    node(n.lhs, depth, "condition");
+                    node(data.then, depth, "then");
+                    node(data.otherwise, depth, "else");
+                    break;
+                }
+                case NodeKind::Compare:
+                case NodeKind::Call:
+                    node(n.lhs, depth, {});
+                    list(n.rhs, depth, {});
+                    break;
+                case NodeKind::LazyBody:
+                    break;
+                default:
+                    node(n.lhs, depth, {});
+                    node(n.rhs, depth, {});
+                    break;
+                }
+            }
+
+            void list(ListRef ref, int depth, std::string_view label) {
+                for (NodeId id : ast_.list(ref))
+                    node(id, depth, label);
+            }
+
+            const Ast& ast_;
+            const TokenStream& tokens_;
+            std::string out_;
+        };
+
+    } // namespace
+
+    std::string FormatAst(const Ast& ast, const TokenStream& tokens) {
+        return AstPrinter(ast, tokens).run();
+    }
+
+} // namespace GC
@@ -0,0 +1,96 @@
+#include "../Parser.h"
+
+#include <algorithm>
+#include <future>
+
+#include "../../Thread/ThreadPool.h"
+
+namespace GC {
+
+    namespace {
+
+        // Below this many tokens per task, hand-off and merging cost more than they save.
+        constexpr size_t MinTaskTokens = 16 * 1024;
+
+        // Tasks per worker, so that stealing can even out declarations of very
+        // different sizes.
+        constexpr size_t TasksPerWorker = 8;
+
+    } // namespace
+
+    //------------------------------------------------------------------------------
+    // Top-level boundaries: one pass over the token kinds tracking `[`/`]` depth.
+    // At depth 0, '#', '@#' and 'enum' start a declaration, which ends with the
+    // `]` that closes its first bracket. Nothing can continue a statement across
+    // those tokens, so every range between two boundaries parses on its own
+    // exactly as it does inside the whole stream.
+    //------------------------------------------------------------------------------
+    std::vector<uint32_t> TopLevelBoundaries(const TokenStream& tokens) {
+        std::vector<uint32_t> boundaries;
+        const std::vector<TokenType>& kinds = tokens.kinds();
+        size_t depth = 0;
+        bool inDeclaration = false;
+        for (size_t i = 0; i < kinds.size(); i++) {
+            switch (kinds[i]) {
+            case TokenType::Hash:
+            case TokenType::At:
+            case TokenType::Enum:
+                // The header of a declaration (`enum #Name`, ...) can hold these too.
+                if (depth == 0 && !inDeclaration
+                    && (kinds[i] != TokenType::At || (i + 1 < kinds.size() && kinds[i + 1] == TokenType::Hash))) {
+                    boundaries.push_back(static_cast<uint32_t>(i));
+                    inDeclaration = true;
+                }
+                break;
+            case TokenType::LeftBracket:
+                depth++;
+                break;
+            case TokenType::RightBracket:
+                if (depth > 0 && --depth == 0 && inDeclaration) {
+                    boundaries.push_back(static_cast<uint32_t>(i + 1));
+                    inDeclaration = false;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+        return boundaries;
+    }
+
+    //------------------------------------------------------------------------------
+    // Parallel parsing: the boundaries are grouped into consecutive ranges of at
+    // least MinTaskTokens, each range is parsed into its own tree on the pool, and
+    // the trees are concatenated in source order.
+    //------------------------------------------------------------------------------
+    Ast Parse(const TokenStream& tokens, ThreadPool& pool, CompilationContext& context) {
+        if (tokens.size() < 2 * MinTaskTokens || pool.size() < 2)
+            return Parse(tokens, context);
+
+        const size_t end = tokens.size() - 1;   // The EndOfFile token.
+        const size_t taskTokens = std::max(MinTaskTokens, end / (pool.size() * TasksPerWorker));
+        std::vector<size_t> splits{ 0 };
+        for (uint32_t boundary : TopLevelBoundaries(tokens)) {
+            if (boundary >= splits.back() + taskTokens && end - boundary >= taskTokens / 2)
+                splits.push_back(boundary);
+        }
+        splits.push_back(end);
+        if (splits.size() < 3)
+            return Parse(tokens, context);
+
+        std::vector<std::future<Ast>> pending;
+        pending.reserve(splits.size() - 1);
+        for (size_t k = 0; k + 1 < splits.size(); k++) {
+            pending.push_back(pool.submit([&tokens, &context, begin = splits[k], limit = splits[k + 1]] {
+                return Parser(tokens, context, begin, limit).parse();
+            }));
+        }
+
+        std::vector<Ast> parts;
+        parts.reserve(pending.size());
+        for (std::future<Ast>& part : pending)
+            parts.push_back(part.get());
+        return Ast::Concatenate(parts);
+    }
+
+} // namespace GC
@@ -0,0 +1,949 @@
+#include "../Parser.h"
+
+#include <algorithm>
+
+#include "../Precedence.h"
+
+namespace GC {
+
+    namespace {
+
+        bool IsBuiltinType(TokenType type) noexcept {
+            return type >= TokenType::U8 && type <= TokenType::Str;
+        }
+
+        // Tokens that can only begin a statement; error recovery resumes at them.
+        bool StartsStatement(TokenType type) noexcept {
+            switch (type) {
+            case TokenType::Import:
+            case TokenType::Iter:
+            case TokenType::While:
+            case TokenType::If:
+            case TokenType::Enum:
+            case TokenType::Compare:
+            case TokenType::Public:
+            case TokenType::Private:
+            case TokenType::Continue:
+            case TokenType::Break:
+            case TokenType::ExitProgram:
+            case TokenType::Tuple:
+            case TokenType::Destroy:
+            case TokenType::Delete:
+            case TokenType::Arrow:
+            case TokenType::At:
+            case TokenType::Hash:
+                return true;
+            default:
+                return IsBuiltinType(type);
+            }
+        }
+
+        // What an expected token is called in a diagnostic.
+        std::string Describe(TokenType type) {
+            switch (TokenTypeCategory(type)) {
+            case TokenCategory::Identifier: return "a name";
+            case TokenCategory::Literal:    return "a literal";
+            case TokenCategory::Special:    return "end of file";
+            default:                        return "'" + std::string(TokenTypeName(type)) + "'";
+            }
+        }
+
+        // One level of statement or type nesting, for the scope of a parse function.
+        class NestingScope {
+        public:
+            explicit NestingScope(uint32_t& depth) noexcept : depth_(++depth) {}
+            ~NestingScope() { depth_--; }
+
+            NestingScope(const NestingScope&) = delete;
+            NestingScope& operator=(const NestingScope&) = delete;
+
+        private:
+            uint32_t& depth_;
+        };
+
+    } // namespace
+
+    //------------------------------------------------------------------------------
+    // 1. Setup and Helpers
+    //------------------------------------------------------------------------------
+    Parser::Parser(const TokenStream& tokens, CompilationContext& context, BodyParsing bodies)
+        : Parser(tokens, context, 0, tokens.empty() ? 0 : tokens.size() - 1, bodies) {}
+
+    Parser::Parser(const TokenStream& tokens, CompilationContext& context, size_t begin, size_t end, BodyParsing bodies)
+        : tokens_(tokens)
+        , kinds_(tokens.kinds().data())
+        , count_(tokens.size())
+        , end_(end)
+        , position_(begin)
+        , context_(context)
+        , bodies_(bodies) {
+        // Roughly one node per two tokens and one extra word per four.
+        ast_.nodes_.reserve((end - begin) / 2 + 16);
+        ast_.extra_.reserve((end - begin) / 4 + 16);
+    }
+
+    bool Parser::match(TokenType type) noexcept {
+        if (!at(type))
+            return false;
+        advance();
+        return true;
+    }
+
+    bool Parser::expect(TokenType type, std::string_view context) {
+        if (match(type))
+            return true;
+        error("expected " + Describe(type) + " " + std::string(context));
+        return false;
+    }
+
+    void Parser::error(std::string_view message) {
+        // The real token, also where a range parser sees its end.
+        std::string text(message);
+        if (position_ >= count_ || kinds_[position_] == TokenType::EndOfFile)
+            text += ", found end of file";
+        else
+            text += ", found '" + std::string(tokens_.lexeme(position_)) + "'";
+        uint32_t offset = position_ < count_ ? tokens_.offset(position_) : static_cast<uint32_t>(tokens_.source().size());
+        ast_.diagnostics_.push_back(Diagnostic{ Diagnostic::Severity::Error, offset, context_.storeMessage(text) });
+    }
+
+    NodeId Parser::add(NodeKind kind, uint32_t token, uint32_t lhs, uint32_t rhs, uint16_t flags) {
+        ast_.nodes_.push_back(Node{ kind, flags, token, lhs, rhs });
+        return static_cast<NodeId>(ast_.nodes_.size() - 1);
+    }
+
+    // Moves the children pushed on the scratch stack since `scratchBegin` into a
+    // list in the extra array.
+    ListRef Parser::addList(size_t scratchBegin) {
+        size_t count = scratch_.size() - scratchBegin;
+        if (count == 0)
+            return EmptyList;
+        ListRef ref = static_cast<ListRef>(ast_.extra_.size());
+        ast_.extra_.push_back(static_cast<uint32_t>(count));
+        ast_.extra_.insert(ast_.extra_.end(), scratch_.begin() + scratchBegin, scratch_.end());
+        scratch_.resize(scratchBegin);
+        return ref;
+    }
+
+    uint32_t Parser::addRecord(std::initializer_list<uint32_t> fields) {
+        uint32_t at = static_cast<uint32_t>(ast_.extra_.size());
+        ast_.extra_.insert(ast_.extra_.end(), fields);
+        return at;
+    }
+
+    Ast Parser::parse() {
+        size_t begin = scratch_.size();
+        parseStatements(TokenType::EndOfFile, false);
+        ast_.root_ = add(NodeKind::Module, 0, addList(begin));
+        return std::move(ast_);
+    }
+
+    NodeId Parser::parseBody(Ast& ast, NodeId function) {
+        ast_ = std::move(ast);
+        const size_t diagnosticCount = ast_.diagnostics_.size();
+        uint32_t token = static_cast<uint32_t>(position_);
+        NodeId body = parseBlock();
+        // The range ends at the matching ']', so this only fails on a stream that
+        // does not belong to the tree; keep a body either way.
+        if (body == InvalidNode)
+            body = add(NodeKind::Block, token, EmptyList);
+        ast_.nodes_[function].rhs = body;
+
+        // Keep the diagnostics in source order.
+        std::inplace_merge(ast_.diagnostics_.begin(), ast_.diagnostics_.begin() + diagnosticCount, ast_.diagnostics_.end(),
+            [](const Diagnostic& a, const Diagnostic& b) { return a.offset < b.offset; });
+        ast = std::move(ast_);
+        return body;
+    }
+
+    Ast Parse(const TokenStream& tokens, CompilationContext& context, BodyParsing bodies) {
+        return Parser(tokens, context, bodies).parse();
+    }
+
+    NodeId ParseBody(Ast& ast, const TokenStream& tokens, NodeId function, CompilationContext& context) {
+        const NodeId body = ast[function].rhs;
+        if (body == InvalidNode || ast[body].kind != NodeKind::LazyBody)
+            return body;
+        const uint32_t open = ast[body].token;
+        return Parser(tokens, context, open, ast[body].lhs + 1).parseBody(ast, function);
+    }
+
+    //------------------------------------------------------------------------------
+    // 2. Statements
+    //
+    // Statements are pushed on the scratch stack; a failed one pushes nothing
+    // (except the declarations of a `|` group that came before the error) and
+    // leaves the parser at the offending token.
+    //------------------------------------------------------------------------------
+    void Parser::parseStatements(TokenType end, bool inClass) {
+        while (!at(end) && !at(TokenType::EndOfFile)) {
+            size_t start = position_;
+            if (!parseStatement(inClass))
+                synchronize(end, start);
+        }
+    }
+
+    // Skips the rest of the broken statement that began at `start`: to the next
+    // token that starts one, or to the end of the enclosing block, whichever comes
+    // first outside brackets. At least one token is skipped in all.
+    void Parser::synchronize(TokenType end, size_t start) {
+        int depth = 0;
+        while (!at(TokenType::EndOfFile)) {
+            TokenType type = peek();
+            if (depth == 0 && (type == end || (position_ != start && StartsStatement(type))))
+                return;
+            switch (type) {
+            case TokenType::LeftParen:
+            case TokenType::LeftBracket:
+            case TokenType::LeftBrace:
+                depth++;
+                break;
+            case TokenType::RightParen:
+            case TokenType::RightBracket:
+            case TokenType::RightBrace:
+                if (depth > 0)
+                    depth--;
+                break;
+            default:
+                break;
+            }
+            advance();
+        }
+    }
+
+    // Blocks, classes, `else if` chains and types recurse once per level, so their
+    // nesting is capped at MaxNestingDepth like that of expressions. Past it the
+    // construct is reported and the statement that holds it is skipped.
+    bool Parser::nestedTooDeeply(std::string_view construct) {
+        if (nestingDepth_ < MaxNestingDepth)
+            return false;
+        error(std::string(construct) + " is nested too deeply");
+        return true;
+    }
+
+    bool Parser::parseStatement(bool inClass) {
+        NodeId id = InvalidNode;
+        switch (peek()) {
+        case TokenType::Import:
+            id = parseImport();
+            break;
+        case TokenType::Iter:
+            id = parseIter();
+            break;
+        case TokenType::While:
+            id = parseWhile();
+            break;
+        case TokenType::If:
+            id = parseIf();
+            break;
+        case TokenType::Compare:
+            id = parseCompare();
+            break;
+        case TokenType::Enum:
+            id = parseEnum();
+            break;
+        case TokenType::Hash:
+            id = parseFunctionOrClass(0);
+            break;
+        case TokenType::At:
+            if (peek(1) != TokenType::Hash)
+                return parseDeclarations();
+            advance();
+            id = parseFunctionOrClass(Node::Abstract);
+            break;
+        case TokenType::Public:
+        case TokenType::Private:
+            if (!inClass) {
+                error("access specifiers are only allowed in a class body");
+                return false;
+            }
+            id = add(NodeKind::Access, advance());
+            break;
+        case TokenType::Arrow: {
+            uint32_t token = advance();
+            NodeId value = InvalidNode;
+            if (!at(TokenType::RightBracket) && !at(TokenType::EndOfFile)) {
+                value = parseExpression();
+                if (value == InvalidNode)
+                    return false;
+            }
+            id = add(NodeKind::Return, token, value);
+            break;
+        }
+        case TokenType::ExitProgram:
+        case TokenType::Destroy:
+        case TokenType::Delete: {
+            NodeKind kind = at(TokenType::ExitProgram) ? NodeKind::Exit
+                : at(TokenType::Destroy) ? NodeKind::Destroy : NodeKind::Delete;
+            uint32_t token = advance();
+            NodeId operand = parseExpression();
+            if (operand == InvalidNode)
+                return false;
+            id = add(kind, token, operand);
+            break;
+        }
+        case TokenType::Break:
+            id = add(NodeKind::Break, advance());
+            break;
+        case TokenType::Continue:
+            id = add(NodeKind::Continue, advance());
+            break;
+        default:
+            if (looksLikeDeclaration())
+                return parseDeclarations();
+            id = parseExpression();
+            break;
+        }
+        if (id == InvalidNode)
+            return false;
+        scratch_.push_back(id);
+        return true;
+    }
+
+    // A statement that starts with a type is a declaration: a type keyword,
+    // `vec<`, or a type name followed by the declared name, possibly with type
+    // arguments and pointer stars in between.
+    bool Parser::looksLikeDeclaration() const {
+        TokenType first = peek();
+        if (IsBuiltinType(first) || first == TokenType::Tuple)
+            return true;
+        if (first == TokenType::Vec)
+            return peek(1) == TokenType::Less;
+        if (first != TokenType::Identifier)
+            return false;
+
+        size_t k = 1;
+        if (peek(k) == TokenType::Less) {
+            int depth = 0;
+            do {
+                switch (peek(k)) {
+                case TokenType::Less:
+                    depth++;
+                    break;
+                case TokenType::Greater:
+                    depth--;
+                    break;
+                case TokenType::Identifier:
+                case TokenType::Vec:
+                case TokenType::Tuple:
+                case TokenType::Comma:
+                case TokenType::Multiply:
+                case TokenType::LeftParen:
+                case TokenType::RightParen:
+                case TokenType::IntegerLiteral:
+                    break;
+                default:
+                    if (!IsBuiltinType(peek(k)))
+                        return false;
+                    break;
+                }
+                k++;
+            } while (depth > 0);
+        }
+        while (peek(k) == TokenType::Multiply)
+            k++;
+        return peek(k) == TokenType::Identifier;
+    }
+
+    // `[@]type name [= value]`, repeated with `|` separators.
+    bool Parser::parseDeclarations() {
+        do {
+            uint16_t flags = match(TokenType::At) ? Node::Const : 0;
+            NodeId type = parseType();
+            if (type == InvalidNode)
+                return false;
+            uint32_t name = static_cast<uint32_t>(position_);
+            if (!expect(TokenType::Identifier, "after the type of a declaration"))
+                return false;
+            NodeId value = InvalidNode;
+            if (match(TokenType::Assign)) {
+                value = parseExpression();
+                if (value == InvalidNode)
+                    return false;
+            }
+            scratch_.push_back(add(NodeKind::VarDecl, name, type, value, flags));
+        } while (match(TokenType::Pipe));
+        return true;
+    }
+
+    // `import &"file"` or `import &dependence { name, ... }`.
+    NodeId Parser::parseImport() {
+        advance();
+        if (!expect(TokenType::Ampersand, "after 'import'"))
+            return InvalidNode;
+        if (!at(TokenType::StringLiteral) && !at(TokenType::Identifier)) {
+            error("expected a file name or a dependency after 'import &'");
+            return InvalidNode;
+        }
+        uint32_t target = advance();
+
+        size_t begin = scratch_.size();
+        if (match(TokenType::LeftBrace)) {
+            do {
+                uint32_t name = static_cast<uint32_t>(position_);
+                if (!expect(TokenType::Identifier, "in the import list")) {
+                    scratch_.resize(begin);
+                    return InvalidNode;
+                }
+                scratch_.push_back(add(NodeKind::Name, name));
+            } while (match(TokenType::Comma));
+            if (!expect(TokenType::RightBrace, "to close the import list")) {
+                scratch_.resize(begin);
+                return InvalidNode;
+            }
+        }
+        return add(NodeKind::Import, target, addList(begin));
+    }
+
+    // `#name [<generics>]` followed by a parameter list is a function, by a body
+    // or `<->` a class. `flags` is Abstract after '@'.
+    NodeId Parser::parseFunctionOrClass(uint16_t flags) {
+        advance();
+        uint32_t name = static_cast<uint32_t>(position_);
+        if (!expect(TokenType::Identifier, "after '#'"))
+            return InvalidNode;
+        ListRef generics = EmptyList;
+        if (at(TokenType::Less) && !parseGenericParams(generics))
+            return InvalidNode;
+        if (at(TokenType::LeftParen))
+            return parseFunction(name, generics, flags);
+        if (flags & Node::Abstract) {
+            error("expected '(' after the name of an abstract function");
+            return InvalidNode;
+        }
+        return parseClass(name, generics);
+    }
+
+    bool Parser::parseGenericParams(ListRef& out) {
+        advance();
+        size_t begin = scratch_.size();
+        do {
+            uint32_t name = static_cast<uint32_t>(position_);
+            if (!expect(TokenType::Identifier, "in the generic parameters")) {
+                scratch_.resize(begin);
+                return false;
+            }
+            NodeId constraint = InvalidNode;
+            if (match(TokenType::Colon)) {
+                constraint = parseType();
+                if (constraint == InvalidNode) {
+                    scratch_.resize(begin);
+                    return false;
+                }
+            }
+            scratch_.push_back(add(NodeKind::GenericParam, name, constraint));
+        } while (match(TokenType::Comma));
+        if (!expect(TokenType::Greater, "to close the generic parameters")) {
+            scratch_.resize(begin);
+            return false;
+        }
+        out = addList(begin);
+        return true;
+    }
+
+    NodeId Parser::parseFunction(uint32_t name, ListRef generics, uint16_t flags) {
+        advance();
+        size_t begin = scratch_.size();
+        if (!at(TokenType::RightParen)) {
+            do {
+                NodeId param = parseParam();
+                if (param == InvalidNode) {
+                    scratch_.resize(begin);
+                    return InvalidNode;
+                }
+                scratch_.push_back(param);
+            } while (match(TokenType::Comma));
+        }
+        if (!expect(TokenType::RightParen, "to close the parameter list")) {
+            scratch_.resize(begin);
+            return InvalidNode;
+        }
+        ListRef params = addList(begin);
+
+        NodeId returnType = InvalidNode;
+        if (match(TokenType::Arrow)) {
+            returnType = parseType();
+            if (returnType == InvalidNode)
+                return InvalidNode;
+        }
+        NodeId body = InvalidNode;
+        if (!(flags & Node::Abstract)) {
+            body = bodies_ == BodyParsing::Lazy ? skipBlock() : parseBlock();
+            if (body == InvalidNode)
+                return InvalidNode;
+        }
+        return add(NodeKind::Function, name, addRecord({ generics, params, returnType }), body, flags);
+    }
+
+    // `[@]type name [(member)]`: the optional member is initialized from the parameter.
+    NodeId Parser::parseParam() {
+        uint16_t flags = match(TokenType::At) ? Node::Const : 0;
+        NodeId type = parseType();
+        if (type == InvalidNode)
+            return InvalidNode;
+        uint32_t name = static_cast<uint32_t>(position_);
+        if (!expect(TokenType::Identifier, "after the type of a parameter"))
+            return InvalidNode;
+        NodeId member = InvalidNode;
+        if (match(TokenType::LeftParen)) {
+            uint32_t token = static_cast<uint32_t>(position_);
+            if (!expect(TokenType::Identifier, "for the member a parameter initializes"))
+                return InvalidNode;
+            member = add(NodeKind::Name, token);
+            if (!expect(TokenType::RightParen, "after the initialized member"))
+                return InvalidNode;
+        }
+        return add(NodeKind::Param, name, type, member, flags);
+    }
+
+    // `[<-> Base(arguments)] [ members ]`.
+    NodeId Parser::parseClass(uint32_t name, ListRef generics) {
+        if (nestedTooDeeply("class"))
+            return InvalidNode;
+        NestingScope scope(nestingDepth_);
+        NodeId base = InvalidNode;
+        ListRef baseArguments = EmptyList;
+        if (match(TokenType::BiArrow)) {
+            base = parseType();
+            if (base == InvalidNode)
+                return InvalidNode;
+            if (match(TokenType::LeftParen) && !parseTypeArguments(TokenType::RightParen, baseArguments))
+                return InvalidNode;
+        }
+        if (!expect(TokenType::LeftBracket, "to open the class body"))
+            return InvalidNode;
+        size_t begin = scratch_.size();
+        parseStatements(TokenType::RightBracket, true);
+        if (!expect(TokenType::RightBracket, "to close the class body")) {
+            scratch_.resize(begin);
+            return InvalidNode;
+        }
+        ListRef members = addList(begin);
+        return add(NodeKind::Class, name, addRecord({ generics, base, baseArguments }), members);
+    }
+
+    // `enum [name | #name<generics>] [( type )] [ member, ... ]`.
+    NodeId Parser::parseEnum() {
+        uint32_t name = advance();
+        ListRef generics = EmptyList;
+        if (match(TokenType::Hash)) {
+            name = static_cast<uint32_t>(position_);
+            if (!expect(TokenType::Identifier, "after 'enum #'"))
+                return InvalidNode;
+            if (at(TokenType::Less) && !parseGenericParams(generics))
+                return InvalidNode;
+        }
+        else if (at(TokenType::Identifier)) {
+            name = advance();
+        }
+
+        NodeId underlying = InvalidNode;
+        if (match(TokenType::LeftParen)) {
+            underlying = parseType();
+            if (underlying == InvalidNode || !expect(TokenType::RightParen, "after the enum's type"))
+                return InvalidNode;
+        }
+
+        if (!expect(TokenType::LeftBracket, "to open the enum body"))
+            return InvalidNode;
+        size_t begin = scratch_.size();
+        while (!at(TokenType::RightBracket)) {
+            NodeId member = parseEnumMember();
+            if (member == InvalidNode) {
+                scratch_.resize(begin);
+                return InvalidNode;
+            }
+            scratch_.push_back(member);
+            if (!match(TokenType::Comma))
+                break;
+        }
+        if (!expect(TokenType::RightBracket, "to close the enum body")) {
+            scratch_.resize(begin);
+            return InvalidNode;
+        }
+        ListRef members = addList(begin);
+        return add(NodeKind::Enum, name, addRecord({ generics, underlying }), members);
+    }
+
+    // `name [( type )] [= value]`.
+    NodeId Parser::parseEnumMember() {
+        uint32_t name = static_cast<uint32_t>(position_);
+        if (!expect(TokenType::Identifier, "for an enum member"))
+            return InvalidNode;
+        NodeId payload = InvalidNode;
+        if (match(TokenType::LeftParen)) {
+            payload = parseType();
+            if (payload == InvalidNode || !expect(TokenType::RightParen, "after the member's type"))
+                return InvalidNode;
+        }
+        NodeId value = InvalidNode;
+        if (match(TokenType::Assign)) {
+            value = parseExpression();
+            if (value == InvalidNode)
+                return InvalidNode;
+        }
+        return add(NodeKind::EnumMember, name, payload, value);
+    }
+
+    // `iter ( source | name ) [ ... ]` or `iter ( source | (name, ...) ) [ ... ]`.
+    NodeId Parser::parseIter() {
+        uint32_t token = advance();
+        if (!expect(TokenType::LeftParen, "after 'iter'"))
+            return InvalidNode;
+        NodeId source = parseExpression();
+        if (source == InvalidNode || !expect(TokenType::Pipe, "between the iterated value and the element name"))
+            return InvalidNode;
+
+        size_t begin = scratch_.size();
+        bool tuple = match(TokenType::LeftParen);
+        do {
+            uint32_t name = static_cast<uint32_t>(position_);
+            if (!expect(TokenType::Identifier, "for the iterated element")) {
+                scratch_.resize(begin);
+                return InvalidNode;
+            }
+            scratch_.push_back(add(NodeKind::Name, name));
+        } while (tuple && match(TokenType::Comma));
+        if ((tuple && !expect(TokenType::RightParen, "to close the element names"))
+            || !expect(TokenType::RightParen, "to close the iter header")) {
+            scratch_.resize(begin);
+            return InvalidNode;
+        }
+        ListRef bindings = addList(begin);
+
+        NodeId body = parseBlock();
+        if (body == InvalidNode)
+            return InvalidNode;
+        return add(NodeKind::Iter, token, addRecord({ source, bindings }), body);
+    }
+
+    NodeId Parser::parseWhile() {
+        uint32_t token = advance();
+        NodeId condition = parseCondition("'while'");
+        if (condition == InvalidNode)
+            return InvalidNode;
+        NodeId body = parseBlock();
+        if (body == InvalidNode)
+            return InvalidNode;
+        return add(NodeKind::While, token, condition, body);
+    }
+
+    // `if ( condition ) [ ... ]`, then any number of `else if`, then `else [ ... ]`.
+    NodeId Parser::parseIf() {
+        uint32_t token = advance();
+        NodeId condition = parseCondition("'if'");
+        if (condition == InvalidNode)
+            return InvalidNode;
+        NodeId then = parseBlock();
+        if (then == InvalidNode)
+            return InvalidNode;
+        NodeId otherwise = InvalidNode;
+        if (match(TokenType::Else)) {
+            if (at(TokenType::If)) {
+                if (nestedTooDeeply("'else if' chain"))
+                    return InvalidNode;
+                NestingScope scope(nestingDepth_);
+                otherwise = parseIf();
+            }
+            else {
+                otherwise = parseBlock();
+            }
+            if (otherwise == InvalidNode)
+                return InvalidNode;
+        }
+        return add(NodeKind::If, token, condition, addRecord({ then, otherwise }));
+    }
+
+    // `compare ( value ) [ on ( value ) [ ... ] ... default [ ... ] ]`.
+    NodeId Parser::parseCompare() {
+        uint32_t token = advance();
+        NodeId subject = parseCondition("'compare'");
+        if (subject == InvalidNode || !expect(TokenType::LeftBracket, "to open the compare body"))
+            return InvalidNode;
+
+        size_t begin = scratch_.size();
+        while (!at(TokenType::RightBracket) && !at(TokenType::EndOfFile)) {
+            NodeId branch = InvalidNode;
+            if (at(TokenType::On)) {
+                uint32_t on = advance();
+                NodeId value = parseCondition("'on'");
+                NodeId body = value == InvalidNode ? InvalidNode : parseBlock();
+                if (body != InvalidNode)
+                    branch = add(NodeKind::On, on, value, body);
+            }
+            else if (at(TokenType::Default)) {
+                uint32_t fallback = advance();
+                NodeId body = parseBlock();
+                if (body != InvalidNode)
+                    branch = add(NodeKind::Default, fallback, InvalidNode, body);
+            }
+            else {
+                error("expected 'on' or 'default' in a compare body");
+            }
+            if (branch == InvalidNode) {
+                scratch_.resize(begin);
+                return InvalidNode;
+            }
+            scratch_.push_back(branch);
+        }
+        if (!expect(TokenType::RightBracket, "to close the compare body")) {
+            scratch_.resize(begin);
+            return InvalidNode;
+        }
+        return add(NodeKind::Compare, token, subject, addList(begin));
+    }
+
+    NodeId Parser::parseBlock() {
+        if (nestedTooDeeply("block"))
+            return InvalidNode;
+        NestingScope scope(nestingDepth_);
+        uint32_t token = static_cast<uint32_t>(position_);
+        if (!expect(TokenType::LeftBracket, "to open a block"))
+            return InvalidNode;
+        size_t begin = scratch_.size();
+        parseStatements(TokenType::RightBracket, false);
+        if (!expect(TokenType::RightBracket, "to close the block")) {
+            scratch_.resize(begin);
+            return InvalidNode;
+        }
+        return add(NodeKind::Block, token, addList(begin));
+    }
+
+    // Lazy function bodies: a jump to the `]` the lexer matched with the `[`. An
+    // unbalanced body is parsed now, to report where it goes wrong.
+    NodeId Parser::skipBlock() {
+        const uint32_t close = at(TokenType::LeftBracket) ? tokens_.matchingBracket(position_) : TokenStream::NoPayload;
+        if (close == TokenStream::NoPayload || close >= end_)
+            return parseBlock();
+        const uint32_t open = advance();
+        position_ = close + 1;
+        return add(NodeKind::LazyBody, open, close);
+    }
+
+    // `( expression )` after `construct`.
+    NodeId Parser::parseCondition(std::string_view construct) {
+        if (!expect(TokenType::LeftParen, "after " + std::string(construct)))
+            return InvalidNode;
+        NodeId condition = parseExpression();
+        if (condition == InvalidNode || !expect(TokenType::RightParen, "after the condition"))
+            return InvalidNode;
+        return condition;
+    }
+
+    //------------------------------------------------------------------------------
+    // 3. Types
+    //
+    // A type keyword, `vec<T>`, `tuple(T, ...)` or a name with optional type
+    // arguments, followed by any number of pointer stars. In a tuple, `T * 3` is
+    // three elements of type T.
+    //------------------------------------------------------------------------------
+    NodeId Parser::parseType() {
+        if (nestedTooDeeply("type"))
+            return InvalidNode;
+        NestingScope scope(nestingDepth_);
+        NodeId type = InvalidNode;
+        TokenType first = peek();
+        if (IsBuiltinType(first)) {
+            type = add(NodeKind::BuiltinType, advance());
+        }
+        else if (first == TokenType::Vec) {
+            uint32_t token = advance();
+            if (!expect(TokenType::Less, "after 'vec'"))
+                return InvalidNode;
+            NodeId element = parseType();
+            if (element == InvalidNode || !expect(TokenType::Greater, "to close the element type"))
+                return InvalidNode;
+            type = add(NodeKind::VecType, token, element);
+        }
+        else if (first == TokenType::Tuple) {
+            uint32_t token = advance();
+            ListRef elements = EmptyList;
+            if (!expect(TokenType::LeftParen, "after 'tuple'") || !parseTypeArguments(TokenType::RightParen, elements))
+                return InvalidNode;
+            type = add(NodeKind::TupleType, token, elements);
+        }
+        else if (first == TokenType::Identifier) {
+            uint32_t token = advance();
+            ListRef arguments = EmptyList;
+            if (match(TokenType::Less) && !parseTypeArguments(TokenType::Greater, arguments))
+                return InvalidNode;
+            type = add(NodeKind::NamedType, token, arguments);
+        }
+        else {
+            error("expected a type");
+            return InvalidNode;
+        }
+
+        while (at(TokenType::Multiply) && peek(1) != TokenType::IntegerLiteral)
+            type = add(NodeKind::PointerType, advance(), type);
+        return type;
+    }
+
+    // Types separated by commas, up to and including `close`.
+    bool Parser::parseTypeArguments(TokenType close, ListRef& out) {
+        size_t begin = scratch_.size();
+        do {
+            NodeId type = parseType();
+            if (type == InvalidNode) {
+                scratch_.resize(begin);
+                return false;
+            }
+            if (at(TokenType::Multiply)) {
+                uint32_t star = advance();
+                type = add(NodeKind::RepeatType, star, type, add(NodeKind::Literal, advance()));
+            }
+            scratch_.push_back(type);
+        } while (match(TokenType::Comma));
+        if (!expect(close, "to close the type arguments")) {
+            scratch_.resize(begin);
+            return false;
+        }
+        out = addList(begin);
+        return true;
+    }
+
+    //------------------------------------------------------------------------------
+    // 4. Expressions
+    //
+    // Pratt parsing driven by the binding-power tables of Precedence.h: one loop
+    // handles every infix and postfix operator, and only an operand that binds
+    // tighter than the operator before it recurses. A chain like a + b * c - d
+    // therefore costs at most one call per pending operator, not one per
+    // precedence tier, and every token is visited once. Nesting (parentheses,
+    // prefix operators, right-associative chains) is capped at MaxExpressionDepth,
+    // as that of statements and types is at MaxNestingDepth, so that hostile input
+    // cannot exhaust the stack.
+    //------------------------------------------------------------------------------
+    NodeId Parser::parseExpression(uint8_t minPower) {
+        if (expressionDepth_ == MaxExpressionDepth) {
+            error("expression is nested too deeply");
+            return InvalidNode;
+        }
+        expressionDepth_++;
+
+        NodeId lhs = parseOperand();
+        while (lhs != InvalidNode) {
+            TokenType type = peek();
+            if (Precedence::BindingPower postfix = Precedence::Postfix(type); postfix.isOperator()) {
+                if (postfix.left < minPower)
+                    break;
+                lhs = parsePostfix(lhs, postfix.kind);
+                continue;
+            }
+            Precedence::BindingPower infix = Precedence::Infix(type);
+            if (!infix.isOperator() || infix.left < minPower)
+                break;
+            uint32_t token = advance();
+            NodeId rhs = parseExpression(infix.right);
+            lhs = rhs == InvalidNode ? InvalidNode : add(infix.kind, token, lhs, rhs);
+        }
+
+        expressionDepth_--;
+        return lhs;
+    }
+
+    // A prefix operator applied to its operand, or a primary expression.
+    NodeId Parser::parseOperand() {
+        Precedence::BindingPower prefix = Precedence::Prefix(peek());
+        if (!prefix.isOperator())
+            return parsePrimary();
+        uint32_t token = advance();
+        NodeId operand = parseExpression(prefix.right);
+        return operand == InvalidNode ? InvalidNode : add(prefix.kind, token, operand);
+    }
+
+    // Calls, indexing, member access and `::` on `value`.
+    NodeId Parser::parsePostfix(NodeId value, NodeKind kind) {
+        switch (kind) {
+        case NodeKind::Call: {
+            uint32_t token = advance();
+            ListRef arguments = EmptyList;
+            return parseExpressionList(TokenType::RightParen, arguments, scratch_.size())
+                ? add(NodeKind::Call, token, value, arguments) : InvalidNode;
+        }
+        case NodeKind::Index: {
+            uint32_t token = advance();
+            NodeId index = parseExpression();
+            return index != InvalidNode && expect(TokenType::RightBracket, "to close the index")
+                ? add(NodeKind::Index, token, value, index) : InvalidNode;
+        }
+        case NodeKind::Member:
+            advance();
+            if (!at(TokenType::Identifier) && !at(TokenType::IntegerLiteral)) {
+                error("expected a member name or tuple position after '.'");
+                return InvalidNode;
+            }
+            return add(NodeKind::Member, advance(), value);
+        default: {
+            advance();
+            uint32_t name = static_cast<uint32_t>(position_);
+            return expect(TokenType::Identifier, "after '::'") ? add(kind, name, value) : InvalidNode;
+        }
+        }
+    }
+
+    NodeId Parser::parsePrimary() {
+        switch (peek()) {
+        case TokenType::IntegerLiteral:
+        case TokenType::FloatLiteral:
+        case TokenType::StringLiteral:
+        case TokenType::CharLiteral:
+            return add(NodeKind::Literal, advance());
+        case TokenType::Identifier:
+        case TokenType::Vec:
+            return add(NodeKind::Name, advance());
+        case TokenType::LeftParen: {
+            // A parenthesized expression, or a tuple if there is a comma.
+            uint32_t token = advance();
+            if (match(TokenType::RightParen))
+                return add(NodeKind::Tuple, token, EmptyList);
+            NodeId first = parseExpression();
+            if (first == InvalidNode)
+                return InvalidNode;
+            if (match(TokenType::RightParen))
+                return first;
+            if (!expect(TokenType::Comma, "or ')' after the expression"))
+                return InvalidNode;
+            size_t begin = scratch_.size();
+            scratch_.push_back(first);
+            ListRef elements = EmptyList;
+            if (!parseExpressionList(TokenType::RightParen, elements, begin))
+                return InvalidNode;
+            return add(NodeKind::Tuple, token, elements);
+        }
+        case TokenType::LeftBracket: {
+            uint32_t token = advance();
+            ListRef elements = EmptyList;
+            if (!parseExpressionList(TokenType::RightBracket, elements, scratch_.size()))
+                return InvalidNode;
+            return add(NodeKind::Array, token, elements);
+        }
+        default:
+            error("expected an expression");
+            return InvalidNode;
+        }
+    }
+
+    // Expressions separated by commas (a trailing comma is allowed), up to and
+    // including `close`. The list also takes the elements the caller already
+    // pushed on the scratch stack since `begin`.
+    bool Parser::parseExpressionList(TokenType close, ListRef& out, size_t begin) {
+        while (!at(close)) {
+            NodeId value = parseExpression();
+            if (value == InvalidNode) {
+                scratch_.resize(begin);
+                return false;
+            }
+            scratch_.push_back(value);
+            if (!match(TokenType::Comma))
+                break;
+        }
+        if (!expect(close, "to close the list")) {
+            scratch_.resize(begin);
+            return false;
+        }
+        out = addList(begin);
+        return true;
+    }
+
+} // namespace GC
@@ -0,0 +1,65 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace GC {
+
+    //------------------------------------------------------------------------------
+    // Thread Pool
+    //
+    // A fixed set of worker threads with work stealing: every worker owns a deque
+    // of tasks. Tasks submitted from outside the pool are dealt round-robin, and
+    // tasks submitted by a worker go to its own deque. A worker runs its own tasks
+    // oldest first and, once its deque is empty, steals the newest task of another
+    // worker, so uneven tasks (one huge class next to a hundred small functions)
+    // still keep every thread busy. submit() returns a future for the task's
+    // result; the destructor finishes queued work and joins.
+    //------------------------------------------------------------------------------
+    class ThreadPool {
+    public:
+        // A count of 0 uses one thread per hardware thread.
+        explicit ThreadPool(size_t threadCount = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        size_t size() const noexcept { return workers_.size(); }
+
+        template<typename Fn>
+        std::future<std::invoke_result_t<Fn>> submit(Fn&& fn) {
+            using Result = std::invoke_result_t<Fn>;
+            auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Fn>(fn));
+            std::future<Result> result = task->get_future();
+            push([task] { (*task)(); });
+            return result;
+        }
+
+    private:
+        struct Queue {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        void push(std::function<void()> task);
+        bool pop(size_t worker, std::function<void()>& task);
+        void workerLoop(size_t worker);
+
+        std::vector<std::unique_ptr<Queue>> queues_;    // One per worker.
+        std::vector<std::thread> workers_;
+        std::atomic<size_t> nextQueue_{ 0 };            // Round-robin target for outside submissions.
+        std::atomic<size_t> pending_{ 0 };              // Tasks queued and not yet taken.
+        std::mutex sleepMutex_;
+        std::condition_variable wake_;
+        bool stopping_{ false };
+    };
+
+} // namespace GC
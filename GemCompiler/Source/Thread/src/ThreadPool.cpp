@@ -0,0 +1,95 @@
+#include "../ThreadPool.h"
+
+#include <algorithm>
+
+namespace GC {
+
+    namespace {
+
+        // The pool and queue index of the calling thread, if it is a worker.
+        thread_local const ThreadPool* CurrentPool = nullptr;
+        thread_local size_t CurrentWorker = 0;
+
+    } // namespace
+
+    ThreadPool::ThreadPool(size_t threadCount) {
+        if (threadCount == 0)
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        queues_.reserve(threadCount);
+        for (size_t i = 0; i < threadCount; i++)
+            queues_.push_back(std::make_unique<Queue>());
+        workers_.reserve(threadCount);
+        for (size_t i = 0; i < threadCount; i++)
+            workers_.emplace_back([this, i] { workerLoop(i); });
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (std::thread& worker : workers_)
+            worker.join();
+    }
+
+    void ThreadPool::push(std::function<void()> task) {
+        {
+            // Counted first, and under the sleep lock: a worker cannot miss the
+            // wake-up between checking for work and going to sleep, and the count
+            // never drops below zero when the task is taken right away.
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            pending_.fetch_add(1, std::memory_order_relaxed);
+        }
+        size_t target = CurrentPool == this ? CurrentWorker : nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+        {
+            std::lock_guard<std::mutex> lock(queues_[target]->mutex);
+            queues_[target]->tasks.push_back(std::move(task));
+        }
+        wake_.notify_one();
+    }
+
+    //------------------------------------------------------------------------------
+    // Take the oldest task of the worker's own deque, or steal the newest task of
+    // the first other worker that has one.
+    //------------------------------------------------------------------------------
+    bool ThreadPool::pop(size_t worker, std::function<void()>& task) {
+        for (size_t i = 0; i < queues_.size(); i++) {
+            Queue& queue = *queues_[(worker + i) % queues_.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty())
+                continue;
+            if (i == 0) {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            else {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    //------------------------------------------------------------------------------
+    // Run tasks until the pool is stopping and every queue has drained.
+    //------------------------------------------------------------------------------
+    void ThreadPool::workerLoop(size_t worker) {
+        CurrentPool = this;
+        CurrentWorker = worker;
+        for (;;) {
+            std::function<void()> task;
+            if (pop(worker, task)) {
+                task();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            wake_.wait(lock, [this] { return stopping_ || pending_.load(std::memory_order_relaxed) > 0; });
+            if (stopping_ && pending_.load(std::memory_order_relaxed) == 0)
+                return;
+        }
+    }
+
+} // namespace GC
@@ -0,0 +1,102 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+#include "Simd.h"
+#include "UnicodeTables.h"
+
+namespace GC::CharClass {
+
+    //------------------------------------------------------------------------------
+    // 1. Byte Classes
+    //
+    // One table lookup per byte instead of <cctype>, which depends on the locale and
+    // is undefined for negative chars. Bytes >= 0x80 are only marked NonAscii; the
+    // lexer decodes them and asks the XID tables below.
+    //------------------------------------------------------------------------------
+    enum : uint8_t {
+        Space         = 1 << 0,
+        Digit         = 1 << 1,
+        HexDigit      = 1 << 2,
+        IdentStart    = 1 << 3,     // [A-Za-z_]
+        IdentContinue = 1 << 4,     // [A-Za-z0-9_@#]
+        NonAscii      = 1 << 5,
+    };
+
+    inline constexpr std::array<uint8_t, 256> Table = [] {
+        std::array<uint8_t, 256> table{};
+        for (int c = 0; c < 256; c++) {
+            uint8_t bits = 0;
+            bool upper = c >= 'A' && c <= 'Z';
+            bool lower = c >= 'a' && c <= 'z';
+            bool digit = c >= '0' && c <= '9';
+            if (Simd::IsSpace(static_cast<char>(c)))
+                bits |= Space;
+            if (digit)
+                bits |= Digit | HexDigit | IdentContinue;
+            if ((c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'))
+                bits |= HexDigit;
+            if (upper || lower || c == '_')
+                bits |= IdentStart | IdentContinue;
+            if (c == '@' || c == '#')
+                bits |= IdentContinue;
+            if (c >= 0x80)
+                bits |= NonAscii;
+            table[c] = bits;
+        }
+        return table;
+    }();
+
+    constexpr bool Is(char c, uint8_t mask) noexcept {
+        return (Table[static_cast<unsigned char>(c)] & mask) != 0;
+    }
+
+    //------------------------------------------------------------------------------
+    // 2. UTF-8 Decoding
+    //
+    // Decodes one well-formed sequence at `p` and returns its length, or 0 for a
+    // malformed or truncated one (overlong forms and surrogates included).
+    //------------------------------------------------------------------------------
+    constexpr int DecodeUtf8(const char* p, const char* end, char32_t& codePoint) noexcept {
+        const auto byte = [&](int i) { return static_cast<unsigned char>(p[i]); };
+        const auto continuation = [&](int i) { return p + i < end && (byte(i) & 0xC0) == 0x80; };
+        unsigned char lead = byte(0);
+        if (lead < 0x80) {
+            codePoint = lead;
+            return 1;
+        }
+        if (lead >= 0xC2 && lead <= 0xDF && continuation(1)) {
+            codePoint = (char32_t(lead & 0x1F) << 6) | (byte(1) & 0x3F);
+            return 2;
+        }
+        if (lead >= 0xE0 && lead <= 0xEF && continuation(1) && continuation(2)) {
+            codePoint = (char32_t(lead & 0x0F) << 12) | (char32_t(byte(1) & 0x3F) << 6) | (byte(2) & 0x3F);
+            bool overlong = codePoint < 0x800;
+            bool surrogate = codePoint >= 0xD800 && codePoint <= 0xDFFF;
+            return overlong || surrogate ? 0 : 3;
+        }
+        if (lead >= 0xF0 && lead <= 0xF4 && continuation(1) && continuation(2) && continuation(3)) {
+            codePoint = (char32_t(lead & 0x07) << 18) | (char32_t(byte(1) & 0x3F) << 12)
+                | (char32_t(byte(2) & 0x3F) << 6) | (byte(3) & 0x3F);
+            return codePoint < 0x10000 || codePoint > 0x10FFFF ? 0 : 4;
+        }
+        return 0;
+    }
+
+    //------------------------------------------------------------------------------
+    // 3. Unicode Identifiers (UAX #31: XID_Start XID_Continue*)
+    //------------------------------------------------------------------------------
+    namespace Detail {
+        constexpr bool XidBit(char32_t codePoint, uint32_t set) noexcept {
+            if (codePoint > 0x10FFFF)
+                return false;
+            const uint64_t* block = Unicode::XidBlocks[Unicode::XidIndex[codePoint >> Unicode::XidBlockBits]];
+            uint32_t bit = codePoint & ((1u << Unicode::XidBlockBits) - 1);
+            return (block[set * Unicode::XidWordsPerSet + bit / 64] >> (bit % 64)) & 1;
+        }
+    } // namespace Detail
+
+    constexpr bool IsXidStart(char32_t codePoint) noexcept { return Detail::XidBit(codePoint, 0); }
+    constexpr bool IsXidContinue(char32_t codePoint) noexcept { return Detail::XidBit(codePoint, 1); }
+
+} // namespace GC::CharClass
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../Unit/Arena.h"
+
+namespace GC {
+
+    //------------------------------------------------------------------------------
+    // 1. Symbol Ids
+    //------------------------------------------------------------------------------
+    using SymbolId = uint32_t;
+    inline constexpr SymbolId InvalidSymbol = UINT32_MAX;
+
+    //------------------------------------------------------------------------------
+    // 2. The Interner
+    //
+    // Gives every distinct identifier a dense SymbolId (0, 1, 2, ...) and stores its
+    // characters once, in an arena that is only freed with the interner.
+    // Name equality downstream is then an integer compare. Lookups of known names
+    // take a shared lock, so concurrent users mostly proceed without contention.
+    // The numbering of ids depends on the order in which names are first seen, so
+    // parallel lexers intern into one interner per chunk and renumber in order.
+    //------------------------------------------------------------------------------
+    class Interner {
+    public:
+        Interner() = default;
+        Interner(const Interner&) = delete;
+        Interner& operator=(const Interner&) = delete;
+
+        SymbolId intern(std::string_view name);
+        std::string_view name(SymbolId id) const;
+        size_t size() const;
+        ArenaStats arenaStats() const;
+
+    private:
+        mutable std::shared_mutex mutex_;
+        std::unordered_map<std::string_view, SymbolId> ids_;
+        std::vector<std::string_view> names_;
+        Arena arena_;       // Characters of the names.
+    };
+
+} // namespace GC
@@ -0,0 +1,107 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "Token.h"
+
+namespace GC {
+
+    //------------------------------------------------------------------------------
+    // 1. Keyword Table
+    //------------------------------------------------------------------------------
+    struct Keyword {
+        std::string_view text;
+        TokenType type;
+    };
+
+    // Built from the Keyword rows of TokenSpellings (Token.h).
+    inline constexpr size_t KeywordCount = [] {
+        size_t count = 0;
+        for (const TokenSpelling& spelling : TokenSpellings)
+            count += spelling.category == TokenCategory::Keyword;
+        return count;
+    }();
+
+    inline constexpr std::array<Keyword, KeywordCount> Keywords = [] {
+        std::array<Keyword, KeywordCount> keywords{};
+        size_t i = 0;
+        for (const TokenSpelling& spelling : TokenSpellings) {
+            if (spelling.category == TokenCategory::Keyword)
+                keywords[i++] = Keyword{ spelling.text, spelling.type };
+        }
+        return keywords;
+    }();
+
+    //------------------------------------------------------------------------------
+    // 2. Perfect Hash
+    //
+    // Every keyword is reduced to a 32-bit key made of its length, first, second and
+    // last characters; a multiplicative hash then maps the key to one of 64 slots.
+    // The multiplier is searched at compile time so that no two keywords share a
+    // slot, which leaves a single string compare per identifier.
+    //------------------------------------------------------------------------------
+    namespace KeywordHash {
+
+        inline constexpr uint32_t SlotBits = 6;
+        inline constexpr uint32_t SlotCount = 1u << SlotBits;
+
+        constexpr uint32_t key(std::string_view text) noexcept {
+            const auto byte = [&](size_t i) { return static_cast<uint32_t>(static_cast<unsigned char>(text[i])); };
+            uint32_t second = text.size() > 1 ? byte(1) : 0;
+            return (static_cast<uint32_t>(text.size()) << 24) | (byte(0) << 16) | (second << 8) | byte(text.size() - 1);
+        }
+
+        constexpr uint32_t slot(uint32_t key, uint32_t multiplier) noexcept {
+            return (key * multiplier) >> (32 - SlotBits);
+        }
+
+        constexpr bool isPerfect(uint32_t multiplier) {
+            std::array<bool, SlotCount> used{};
+            for (const Keyword& keyword : Keywords) {
+                uint32_t s = slot(key(keyword.text), multiplier);
+                if (used[s])
+                    return false;
+                used[s] = true;
+            }
+            return true;
+        }
+
+        constexpr uint32_t findMultiplier() {
+            // Walk odd multipliers from a fixed LCG until one is collision-free.
+            uint32_t state = 0x9E3779B9u;
+            for (int attempt = 0; attempt < 100000; attempt++) {
+                state = state * 1664525u + 1013904223u;
+                if (isPerfect(state | 1u))
+                    return state | 1u;
+            }
+            return 0;
+        }
+
+        inline constexpr uint32_t Multiplier = findMultiplier();
+        static_assert(Multiplier != 0, "No collision-free multiplier for the keyword table");
+
+        // Slot -> index into Keywords, or -1 for an empty slot.
+        inline constexpr std::array<int8_t, SlotCount> Slots = [] {
+            std::array<int8_t, SlotCount> slots{};
+            slots.fill(-1);
+            for (size_t i = 0; i < std::size(Keywords); i++)
+                slots[slot(key(Keywords[i].text), Multiplier)] = static_cast<int8_t>(i);
+            return slots;
+        }();
+
+    } // namespace KeywordHash
+
+    //------------------------------------------------------------------------------
+    // 3. Lookup: returns the keyword's type, or TokenType::Identifier.
+    //------------------------------------------------------------------------------
+    constexpr TokenType LookupKeyword(std::string_view ident) noexcept {
+        if (ident.empty())
+            return TokenType::Identifier;
+        int8_t index = KeywordHash::Slots[KeywordHash::slot(KeywordHash::key(ident), KeywordHash::Multiplier)];
+        if (index >= 0 && Keywords[index].text == ident)
+            return Keywords[index].type;
+        return TokenType::Identifier;
+    }
+
+} // namespace GC
@@ -0,0 +1,79 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+namespace GC {
+
+    //------------------------------------------------------------------------------
+    // Lexer Statistics
+    //
+    // Counters for tuning the lexer on a real corpus, compiled in only when
+    // LEXER_STATS is defined (Debug builds of the compiler; Release, Dist and the
+    // benchmarks leave them out). Without it every update is discarded at compile
+    // time and the lexer is unchanged.
+    //
+    // Timing is sampled: one trivia skip in SampleEvery, together with the token
+    // scan that follows it, is timed, and the totals are extrapolated from the
+    // samples, so the clock is read for few tokens. The per-kind array and the
+    // byte counters are updated for every token, though, and that is the real
+    // cost: the lexer runs a third to a half slower with them, which is why
+    // optimized builds leave them out. Every scanned token counts, including
+    // those of discarded speculative parallel chunks and those scanned by
+    // incremental relexing.
+    //------------------------------------------------------------------------------
+#ifdef LEXER_STATS
+    inline constexpr bool LexerStatsEnabled = true;
+#else
+    inline constexpr bool LexerStatsEnabled = false;
+#endif
+
+    struct LexerStats {
+        static constexpr uint64_t SampleEvery = 32;
+
+        std::array<uint64_t, 256> tokens{};     // By TokenType.
+        uint64_t tokenBytes{ 0 };               // Lexeme bytes of all tokens.
+        uint64_t literalBytes{ 0 };             // Lexeme bytes of literal tokens.
+        uint64_t triviaBytes{ 0 };              // Whitespace and comments skipped.
+        uint64_t commentBytes{ 0 };             // Comments skipped, openers included.
+        uint64_t triviaCalls{ 0 };
+        uint64_t triviaSamples{ 0 };
+        uint64_t triviaSampleNanos{ 0 };
+        uint64_t scanCalls{ 0 };
+        uint64_t scanSamples{ 0 };
+        uint64_t scanSampleNanos{ 0 };
+
+        uint64_t bytesScanned() const noexcept { return tokenBytes + triviaBytes; }
+
+        uint64_t tokenCount() const noexcept {
+            uint64_t count = 0;
+            for (uint64_t n : tokens)
+                count += n;
+            return count;
+        }
+
+        // Estimated totals, from the sampled calls.
+        double triviaNanos() const noexcept { return Extrapolate(triviaSampleNanos, triviaSamples, triviaCalls); }
+        double scanNanos() const noexcept { return Extrapolate(scanSampleNanos, scanSamples, scanCalls); }
+
+        void merge(const LexerStats& other) noexcept {
+            for (size_t i = 0; i < tokens.size(); i++)
+                tokens[i] += other.tokens[i];
+            tokenBytes += other.tokenBytes;
+            literalBytes += other.literalBytes;
+            triviaBytes += other.triviaBytes;
+            commentBytes += other.commentBytes;
+            triviaCalls += other.triviaCalls;
+            triviaSamples += other.triviaSamples;
+            triviaSampleNanos += other.triviaSampleNanos;
+            scanCalls += other.scanCalls;
+            scanSamples += other.scanSamples;
+            scanSampleNanos += other.scanSampleNanos;
+        }
+
+    private:
+        static double Extrapolate(uint64_t nanos, uint64_t samples, uint64_t calls) noexcept {
+            return samples ? static_cast<double>(nanos) * static_cast<double>(calls) / static_cast<double>(samples) : 0.0;
+        }
+    };
+
+} // namespace GC
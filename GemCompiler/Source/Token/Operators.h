@@ -0,0 +1,164 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "Token.h"
+
+namespace GC {
+
+    //------------------------------------------------------------------------------
+    // 1. Operator Table
+    //
+    // Every Operator row of TokenSpellings (Token.h), plus the comment openers. The
+    // openers share prefixes with "|", so they go through the same state machine
+    // and longest match decides between "|", "||" and "|--".
+    //------------------------------------------------------------------------------
+    namespace OperatorDfa {
+
+        // Accept codes: a TokenType, or one of these.
+        inline constexpr uint8_t NoMatch = 0xFF;
+        inline constexpr uint8_t LineCommentOpener = 0xFE;
+        inline constexpr uint8_t BlockCommentOpener = 0xFD;
+        static_assert(TokenTypeCount < BlockCommentOpener, "Accept codes overlap the token types");
+
+        struct Pattern {
+            std::string_view text;
+            uint8_t accept;
+        };
+
+        inline constexpr Pattern TriviaOpeners[] = {
+            { "||",  LineCommentOpener },
+            { "|--", BlockCommentOpener },
+        };
+
+        inline constexpr size_t PatternCount = [] {
+            size_t count = std::size(TriviaOpeners);
+            for (const TokenSpelling& spelling : TokenSpellings)
+                count += spelling.category == TokenCategory::Operator;
+            return count;
+        }();
+
+        inline constexpr std::array<Pattern, PatternCount> Patterns = [] {
+            std::array<Pattern, PatternCount> patterns{};
+            size_t i = 0;
+            for (const TokenSpelling& spelling : TokenSpellings) {
+                if (spelling.category == TokenCategory::Operator)
+                    patterns[i++] = Pattern{ spelling.text, static_cast<uint8_t>(spelling.type) };
+            }
+            for (const Pattern& opener : TriviaOpeners)
+                patterns[i++] = opener;
+            return patterns;
+        }();
+
+        //------------------------------------------------------------------------------
+        // 2. Character Classes
+        //
+        // Each byte that occurs in some pattern gets its own class; every other byte
+        // is class 0, which has no transitions.
+        //------------------------------------------------------------------------------
+        inline constexpr std::array<uint8_t, 256> CharClasses = [] {
+            std::array<uint8_t, 256> classes{};
+            uint8_t next = 1;
+            for (const Pattern& pattern : Patterns) {
+                for (char c : pattern.text) {
+                    uint8_t& slot = classes[static_cast<unsigned char>(c)];
+                    if (slot == 0)
+                        slot = next++;
+                }
+            }
+            return classes;
+        }();
+
+        inline constexpr size_t ClassCount = [] {
+            uint8_t highest = 0;
+            for (uint8_t c : CharClasses)
+                highest = c > highest ? c : highest;
+            return static_cast<size_t>(highest) + 1;
+        }();
+
+        // Bytes that can start a comment opener, so trivia skipping only runs the
+        // machine where it can matter.
+        inline constexpr std::array<bool, 256> TriviaStarts = [] {
+            std::array<bool, 256> starts{};
+            for (const Pattern& opener : TriviaOpeners)
+                starts[static_cast<unsigned char>(opener.text[0])] = true;
+            return starts;
+        }();
+
+        //------------------------------------------------------------------------------
+        // 3. Transition Table
+        //
+        // The patterns are inserted into a trie; state 0 is dead and state 1 is the
+        // start. Accept holds the code of the pattern ending in each state.
+        //------------------------------------------------------------------------------
+        inline constexpr uint8_t Dead = 0;
+        inline constexpr uint8_t Start = 1;
+        inline constexpr size_t MaxStates = 64;
+
+        struct Tables {
+            std::array<std::array<uint8_t, ClassCount>, MaxStates> next{};
+            std::array<uint8_t, MaxStates> accept{};
+            size_t stateCount = 0;
+        };
+
+        inline constexpr Tables Machine = [] {
+            Tables tables;
+            tables.accept.fill(NoMatch);
+            tables.stateCount = 2;
+            for (const Pattern& pattern : Patterns) {
+                uint8_t state = Start;
+                for (char c : pattern.text) {
+                    uint8_t& target = tables.next[state][CharClasses[static_cast<unsigned char>(c)]];
+                    if (target == Dead)
+                        target = static_cast<uint8_t>(tables.stateCount++);
+                    state = target;
+                }
+                tables.accept[state] = pattern.accept;
+            }
+            return tables;
+        }();
+
+        static_assert(Machine.stateCount <= MaxStates, "Raise OperatorDfa::MaxStates");
+        static_assert([] {
+            for (const Pattern& pattern : Patterns) {
+                uint8_t state = Start;
+                for (char c : pattern.text)
+                    state = Machine.next[state][CharClasses[static_cast<unsigned char>(c)]];
+                if (Machine.accept[state] != pattern.accept)
+                    return false;
+            }
+            return true;
+        }(), "Two operator patterns have the same spelling");
+
+    } // namespace OperatorDfa
+
+    //------------------------------------------------------------------------------
+    // 4. Matching: longest pattern starting at `begin`. `accept` is NoMatch and
+    // `length` 0 when no pattern matches.
+    //------------------------------------------------------------------------------
+    struct OperatorMatch {
+        uint8_t accept;
+        uint32_t length;
+    };
+
+    constexpr OperatorMatch MatchOperator(const char* begin, const char* end) noexcept {
+        using namespace OperatorDfa;
+        OperatorMatch best{ NoMatch, 0 };
+        uint8_t state = Start;
+        for (const char* p = begin; p < end; p++) {
+            state = Machine.next[state][CharClasses[static_cast<unsigned char>(*p)]];
+            if (state == Dead)
+                break;
+            if (Machine.accept[state] != NoMatch)
+                best = OperatorMatch{ Machine.accept[state], static_cast<uint32_t>(p + 1 - begin) };
+        }
+        return best;
+    }
+
+    constexpr bool IsOperatorStart(char c) noexcept {
+        using namespace OperatorDfa;
+        return Machine.next[Start][CharClasses[static_cast<unsigned char>(c)]] != Dead;
+    }
+
+} // namespace GC
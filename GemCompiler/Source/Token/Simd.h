@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+
+namespace GC::Simd {
+
+    //------------------------------------------------------------------------------
+    // 1. Instruction Set Dispatch
+    //
+    // The scanning kernels below come in scalar, SSE2 and AVX2 flavours. The best
+    // one supported by the running CPU is picked on first use; UseIsa() can force a
+    // lower tier (e.g. for benchmarking), but never one the CPU cannot execute.
+    //------------------------------------------------------------------------------
+    enum class Isa {
+        Scalar,
+        Sse2,
+        Avx2
+    };
+
+    Isa DetectIsa() noexcept;
+    Isa ActiveIsa() noexcept;
+    void UseIsa(Isa isa) noexcept;
+    const char* IsaName(Isa isa) noexcept;
+
+    //------------------------------------------------------------------------------
+    // 2. Scanning Kernels
+    //
+    // All kernels work on the half-open range [begin, end) and return `end` when
+    // nothing matches.
+    //------------------------------------------------------------------------------
+
+    // Whitespace as classified by std::isspace in the "C" locale.
+    constexpr bool IsSpace(char c) noexcept {
+        return c == ' ' || (static_cast<unsigned char>(c) - 9u) <= 4u;
+    }
+
+    // First byte that is not whitespace.
+    const char* SkipSpaces(const char* begin, const char* end) noexcept;
+
+    // First occurrence of `c`.
+    const char* FindByte(const char* begin, const char* end, char c) noexcept;
+
+    // First occurrence of `a` or `b` (e.g. a closing quote or a backslash).
+    const char* FindEitherByte(const char* begin, const char* end, char a, char b) noexcept;
+
+    // Start of the first "--|" block comment terminator.
+    const char* FindBlockCommentEnd(const char* begin, const char* end) noexcept;
+
+    // Number of '\n' bytes.
+    size_t CountNewlines(const char* begin, const char* end) noexcept;
+
+    // Start of the first byte that is not part of a well-formed UTF-8 sequence
+    // (including sequences truncated by `end`).
+    const char* ValidateUtf8(const char* begin, const char* end) noexcept;
+
+} // namespace GC::Simd
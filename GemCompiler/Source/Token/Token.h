@@ -1,37 +1,39 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <string>
 #include <string_view>
 #include <variant>
 #include <optional>
+#include <array>
 #include <vector>
 #include <sstream>
 #include <iostream>
-#include <cctype>
+
+#include "Interner.h"
+#include "LexerStats.h"
+#include "../Unit/CompilationContext.h"
+#include "../Unit/CompilationUnit.h"
+#include "../Unit/Diagnostic.h"
 
 namespace GC {
 
-    //------------------------------------------------------------------------------
-    // 1. Token Location
-    //------------------------------------------------------------------------------
-    struct TokenLocation {
-        int line{ 1 };
-        int column{ 1 };
-
-        friend std::ostream& operator<<(std::ostream& os, const TokenLocation& loc) {
-            os << loc.line << ":" << loc.column;
-            return os;
-        }
-    };
+    class ThreadPool;
 
     //------------------------------------------------------------------------------
-    // 2. Token Literal (for carrying extra parsed data)
+    // 1. Token Literal (for carrying extra parsed data)
     //------------------------------------------------------------------------------
-    using TokenLiteral = std::variant<std::monostate, int, double, char, std::string>;
+    // Integer literals are lexed as uint64_t (a leading '-' is a separate token);
+    // int64_t is there for values produced by later stages such as constant folding.
+    // Decoded strings live in the CompilationContext's arena, so a literal is a
+    // trivially copyable value and dropping one frees nothing.
+    using TokenLiteral = std::variant<std::monostate, uint64_t, int64_t, double, char, std::string_view>;
 
     //------------------------------------------------------------------------------
-    // 3. Token Types
+    // 2. Token Types
     //------------------------------------------------------------------------------
-    enum class TokenType {
+    enum class TokenType : uint8_t {
         // Keywords
         Import,
         Iter,
@@ -117,190 +119,616 @@ namespace GC {
         Unknown
     };
 
+    inline constexpr size_t TokenTypeCount = static_cast<size_t>(TokenType::Unknown) + 1;
+
     //------------------------------------------------------------------------------
-    // 4. The Token Class
+    // 3. Token Spellings
+    //
+    // The single declarative list of token types, in enum order. Keywords.h builds
+    // the keyword table from the Keyword rows and Operators.h builds the operator
+    // state machine from the Operator rows, so a new keyword or operator is one
+    // enum entry plus one row here.
     //------------------------------------------------------------------------------
-    class Token {
+    enum class TokenCategory : uint8_t {
+        Keyword,
+        Literal,
+        Identifier,
+        Operator,       // Operators and punctuation, matched by the operator DFA.
+        Special
+    };
+
+    struct TokenSpelling {
+        TokenType type;
+        TokenCategory category;
+        std::string_view text;      // Source text, or a descriptive name.
+    };
+
+    inline constexpr TokenSpelling TokenSpellings[] = {
+        // Keywords
+        { TokenType::Import,         TokenCategory::Keyword,    "import" },
+        { TokenType::Iter,           TokenCategory::Keyword,    "iter" },
+        { TokenType::While,          TokenCategory::Keyword,    "while" },
+        { TokenType::If,             TokenCategory::Keyword,    "if" },
+        { TokenType::Else,           TokenCategory::Keyword,    "else" },
+        { TokenType::Enum,           TokenCategory::Keyword,    "enum" },
+        { TokenType::Compare,        TokenCategory::Keyword,    "compare" },
+        { TokenType::On,             TokenCategory::Keyword,    "on" },
+        { TokenType::Default,        TokenCategory::Keyword,    "default" },
+        { TokenType::Public,         TokenCategory::Keyword,    "public" },
+        { TokenType::Private,        TokenCategory::Keyword,    "private" },
+        { TokenType::Continue,       TokenCategory::Keyword,    "continue" },
+        { TokenType::Break,          TokenCategory::Keyword,    "break" },
+        { TokenType::ExitProgram,    TokenCategory::Keyword,    "exitProgram" },
+        { TokenType::Vec,            TokenCategory::Keyword,    "vec" },
+        { TokenType::Tuple,          TokenCategory::Keyword,    "tuple" },
+        { TokenType::Destroy,        TokenCategory::Keyword,    "destroy" },
+        { TokenType::Delete,         TokenCategory::Keyword,    "delete" },
+        // Type Keywords
+        { TokenType::U8,             TokenCategory::Keyword,    "u8" },
+        { TokenType::U16,            TokenCategory::Keyword,    "u16" },
+        { TokenType::U32,            TokenCategory::Keyword,    "u32" },
+        { TokenType::U64,            TokenCategory::Keyword,    "u64" },
+        { TokenType::I8,             TokenCategory::Keyword,    "i8" },
+        { TokenType::I16,            TokenCategory::Keyword,    "i16" },
+        { TokenType::I32,            TokenCategory::Keyword,    "i32" },
+        { TokenType::I64,            TokenCategory::Keyword,    "i64" },
+        { TokenType::F32,            TokenCategory::Keyword,    "f32" },
+        { TokenType::F64,            TokenCategory::Keyword,    "f64" },
+        { TokenType::Bool,           TokenCategory::Keyword,    "bool" },
+        { TokenType::Str,            TokenCategory::Keyword,    "str" },
+        // Literals
+        { TokenType::IntegerLiteral, TokenCategory::Literal,    "integer_literal" },
+        { TokenType::FloatLiteral,   TokenCategory::Literal,    "float_literal" },
+        { TokenType::StringLiteral,  TokenCategory::Literal,    "string_literal" },
+        { TokenType::CharLiteral,    TokenCategory::Literal,    "char_literal" },
+        // Identifier
+        { TokenType::Identifier,     TokenCategory::Identifier, "identifier" },
+        // Operators
+        { TokenType::Plus,           TokenCategory::Operator,   "+" },
+        { TokenType::Minus,          TokenCategory::Operator,   "-" },
+        { TokenType::Multiply,       TokenCategory::Operator,   "*" },
+        { TokenType::Divide,         TokenCategory::Operator,   "/" },
+        { TokenType::Modulo,         TokenCategory::Operator,   "%" },
+        { TokenType::Assign,         TokenCategory::Operator,   "=" },
+        { TokenType::Equal,          TokenCategory::Operator,   "==" },
+        { TokenType::NotEqual,       TokenCategory::Operator,   "!=" },
+        { TokenType::Less,           TokenCategory::Operator,   "<" },
+        { TokenType::LessEqual,      TokenCategory::Operator,   "<=" },
+        { TokenType::Greater,        TokenCategory::Operator,   ">" },
+        { TokenType::GreaterEqual,   TokenCategory::Operator,   ">=" },
+        { TokenType::And,            TokenCategory::Operator,   "?+" },
+        { TokenType::Or,             TokenCategory::Operator,   "??" },
+        { TokenType::Not,            TokenCategory::Operator,   "!" },
+        { TokenType::Arrow,          TokenCategory::Operator,   "->" },
+        { TokenType::BiArrow,        TokenCategory::Operator,   "<->" },
+        { TokenType::Range,          TokenCategory::Operator,   ".." },
+        { TokenType::DoubleColon,    TokenCategory::Operator,   "::" },
+        // References
+        { TokenType::Ampersand,      TokenCategory::Operator,   "&" },
+        { TokenType::AmpersandAt,    TokenCategory::Operator,   "&@" },
+        { TokenType::Pipe,           TokenCategory::Operator,   "|" },
+        // Punctuation
+        { TokenType::LeftParen,      TokenCategory::Operator,   "(" },
+        { TokenType::RightParen,     TokenCategory::Operator,   ")" },
+        { TokenType::LeftBrace,      TokenCategory::Operator,   "{" },
+        { TokenType::RightBrace,     TokenCategory::Operator,   "}" },
+        { TokenType::LeftBracket,    TokenCategory::Operator,   "[" },
+        { TokenType::RightBracket,   TokenCategory::Operator,   "]" },
+        { TokenType::Comma,          TokenCategory::Operator,   "," },
+        { TokenType::Semicolon,      TokenCategory::Operator,   ";" },
+        { TokenType::Colon,          TokenCategory::Operator,   ":" },
+        { TokenType::Dot,            TokenCategory::Operator,   "." },
+        // Special symbols
+        { TokenType::At,             TokenCategory::Operator,   "@" },
+        { TokenType::Hash,           TokenCategory::Operator,   "#" },
+        // End-of-File and Unknown
+        { TokenType::EndOfFile,      TokenCategory::Special,    "EOF" },
+        { TokenType::Unknown,        TokenCategory::Special,    "unknown" },
+    };
+
+    static_assert(std::size(TokenSpellings) == TokenTypeCount, "Every token type needs a spelling");
+    static_assert([] {
+        for (size_t i = 0; i < std::size(TokenSpellings); i++) {
+            if (static_cast<size_t>(TokenSpellings[i].type) != i)
+                return false;
+        }
+        return true;
+    }(), "TokenSpellings must list the token types in enum order");
+
+    constexpr std::string_view TokenTypeName(TokenType type) noexcept {
+        size_t index = static_cast<size_t>(type);
+        return index < std::size(TokenSpellings) ? TokenSpellings[index].text : "invalid";
+    }
+
+    constexpr TokenCategory TokenTypeCategory(TokenType type) noexcept {
+        return TokenSpellings[static_cast<size_t>(type)].category;
+    }
+
+    //------------------------------------------------------------------------------
+    // 4. Packed Tokens and the Literal Pool
+    //
+    // A PackedToken is what containers store: 16 bytes, no owned data. The lexeme
+    // is (offset, length) into the source, and the payload is either the SymbolId
+    // of an identifier or the index of a decoded literal in a LiteralPool. Literals
+    // are rare, so keeping them out of line keeps a token vector cache-sized.
+    //------------------------------------------------------------------------------
+    class PackedToken {
     public:
-        Token(TokenType type, std::string lexeme, TokenLocation location)
-            : type_(type)
-            , lexeme_(std::move(lexeme))
-            , location_(location)
-            , literal_(std::monostate{}) {}
+        static constexpr uint32_t NoPayload = UINT32_MAX;
+
+        enum Flags : uint8_t {
+            HasSymbol = 1 << 0,     // payload is a SymbolId.
+            HasLiteral = 1 << 1,    // payload indexes a LiteralPool.
+        };
 
-        Token(TokenType type, std::string lexeme, TokenLocation location, TokenLiteral literal)
+        PackedToken() = default;
+        PackedToken(TokenType type, uint32_t offset, uint32_t length, uint8_t flags = 0, uint32_t payload = NoPayload)
             : type_(type)
-            , lexeme_(std::move(lexeme))
-            , location_(location)
-            , literal_(std::move(literal)) {}
+            , flags_(flags)
+            , offset_(offset)
+            , length_(length)
+            , payload_(payload) {}
+
+        TokenType getType() const noexcept { return type_; }
+        uint8_t getFlags() const noexcept { return flags_; }
+        uint32_t getOffset() const noexcept { return offset_; }
+        uint32_t getLength() const noexcept { return length_; }
+        uint32_t getPayload() const noexcept { return payload_; }
+        SymbolId getSymbol() const noexcept { return (flags_ & HasSymbol) ? payload_ : InvalidSymbol; }
+        bool hasLiteral() const noexcept { return (flags_ & HasLiteral) != 0; }
+
+    private:
+        TokenType type_{ TokenType::Unknown };
+        uint8_t flags_{ 0 };
+        uint32_t offset_{ 0 };
+        uint32_t length_{ 0 };
+        uint32_t payload_{ NoPayload };
+    };
+
+    static_assert(sizeof(PackedToken) <= 16, "PackedToken must stay within 16 bytes");
+
+    // Decoded literal values. An unbounded pool keeps every literal (token streams);
+    // a ring pool recycles its oldest slot, which is all the pull lexer needs since
+    // it only keeps a bounded window of tokens alive.
+    class LiteralPool {
+    public:
+        explicit LiteralPool(uint32_t ringCapacity = 0)
+            : ringCapacity_(ringCapacity) {
+            if (ringCapacity_)
+                literals_.resize(ringCapacity_);
+        }
 
-        // Use the compiler-generated copy/move/destructors.
-        Token(const Token&) = default;
-        Token(Token&&) noexcept = default;
-        Token& operator=(const Token&) = default;
-        Token& operator=(Token&&) noexcept = default;
-        ~Token() = default;
+        uint32_t add(TokenLiteral literal) {
+            if (ringCapacity_) {
+                literals_[next_ % ringCapacity_] = std::move(literal);
+                return next_++;
+            }
+            literals_.push_back(std::move(literal));
+            return static_cast<uint32_t>(literals_.size() - 1);
+        }
+
+        const TokenLiteral& operator[](uint32_t index) const noexcept {
+            return literals_[ringCapacity_ ? index % ringCapacity_ : index];
+        }
+
+        size_t size() const noexcept { return ringCapacity_ ? next_ : literals_.size(); }
+
+    private:
+        std::vector<TokenLiteral> literals_;
+        uint32_t ringCapacity_;
+        uint32_t next_{ 0 };
+    };
+
+    //------------------------------------------------------------------------------
+    // 5. The Token Class
+    //
+    // A Token is a PackedToken together with the source and literal it refers to,
+    // handed out by TokenStream and by the pull lexer. It owns nothing and is cheap
+    // to copy, but it is only valid while the source and the container that made
+    // it are.
+    //------------------------------------------------------------------------------
+    class Token {
+    public:
+        Token() = default;
+        Token(PackedToken packed, std::string_view source, const TokenLiteral* literal = nullptr)
+            : packed_(packed)
+            , source_(source)
+            , literal_(packed.hasLiteral() ? literal : nullptr) {}
 
         // Accessors.
-        TokenType getType() const noexcept { return type_; }
-        const std::string& getLexeme() const noexcept { return lexeme_; }
-        const TokenLocation& getLocation() const noexcept { return location_; }
+        const PackedToken& getPacked() const noexcept { return packed_; }
+        TokenType getType() const noexcept { return packed_.getType(); }
+        std::string_view getLexeme() const noexcept {
+            return std::string_view(source_.data() + packed_.getOffset(), packed_.getLength());
+        }
+        uint32_t getOffset() const noexcept { return packed_.getOffset(); }
+        TokenLocation getLocation(const SourceMap& map) const { return map.locate(packed_.getOffset()); }
+        // Interned name of an identifier token, InvalidSymbol for any other token.
+        SymbolId getSymbol() const noexcept { return packed_.getSymbol(); }
 
-        bool hasLiteral() const noexcept { return !std::holds_alternative<std::monostate>(literal_); }
+        bool hasLiteral() const noexcept { return literal_ != nullptr; }
 
         template<typename T>
         std::optional<T> getLiteral() const noexcept {
-            if (auto ptr = std::get_if<T>(&literal_))
-                return *ptr;
+            if (literal_) {
+                if (auto ptr = std::get_if<T>(literal_))
+                    return *ptr;
+            }
             return std::nullopt;
         }
 
         std::string toString() const {
             std::ostringstream oss;
-            oss << "Token(" << tokenTypeToString(type_) << ", \"" << lexeme_
-                << "\", at " << location_;
+            oss << "Token(" << tokenTypeToString(getType()) << ", \"" << getLexeme()
+                << "\", at offset " << getOffset();
+            appendLiteral(oss);
+            return oss.str();
+        }
+
+        std::string toString(const SourceMap& map) const {
+            std::ostringstream oss;
+            oss << "Token(" << tokenTypeToString(getType()) << ", \"" << getLexeme()
+                << "\", at " << getLocation(map);
+            appendLiteral(oss);
+            return oss.str();
+        }
+
+    private:
+        void appendLiteral(std::ostringstream& oss) const {
             if (hasLiteral())
                 oss << ", literal: " << literalToString();
             oss << ")";
-            return oss.str();
         }
 
-    private:
         std::string tokenTypeToString(TokenType type) const {
-            switch (type) {
-                // Keywords
-            case TokenType::Import:       return "import";
-            case TokenType::Iter:         return "iter";
-            case TokenType::While:        return "while";
-            case TokenType::If:           return "if";
-            case TokenType::Else:         return "else";
-            case TokenType::Enum:         return "enum";
-            case TokenType::Compare:      return "compare";
-            case TokenType::On:           return "on";
-            case TokenType::Default:      return "default";
-            case TokenType::Public:       return "public";
-            case TokenType::Private:      return "private";
-            case TokenType::Continue:     return "continue";
-            case TokenType::Break:        return "break";
-            case TokenType::ExitProgram:  return "exitProgram";
-            case TokenType::Vec:          return "vec";
-            case TokenType::Tuple:        return "tuple";
-            case TokenType::Destroy:      return "destroy";
-            case TokenType::Delete:       return "delete";
-                // Type Keywords
-            case TokenType::U8:           return "u8";
-            case TokenType::U16:          return "u16";
-            case TokenType::U32:          return "u32";
-            case TokenType::U64:          return "u64";
-            case TokenType::I8:           return "i8";
-            case TokenType::I16:          return "i16";
-            case TokenType::I32:          return "i32";
-            case TokenType::I64:          return "i64";
-            case TokenType::F32:          return "f32";
-            case TokenType::F64:          return "f64";
-            case TokenType::Bool:         return "bool";
-            case TokenType::Str:          return "str";
-                // Literals
-            case TokenType::IntegerLiteral: return "integer_literal";
-            case TokenType::FloatLiteral:   return "float_literal";
-            case TokenType::StringLiteral:  return "string_literal";
-            case TokenType::CharLiteral:    return "char_literal";
-                // Identifier
-            case TokenType::Identifier:     return "identifier";
-                // Operators
-            case TokenType::Plus:           return "+";
-            case TokenType::Minus:          return "-";
-            case TokenType::Multiply:       return "*";
-            case TokenType::Divide:         return "/";
-            case TokenType::Modulo:         return "%";
-            case TokenType::Assign:         return "=";
-            case TokenType::Equal:          return "==";
-            case TokenType::NotEqual:       return "!=";
-            case TokenType::Less:           return "<";
-            case TokenType::LessEqual:      return "<=";
-            case TokenType::Greater:        return ">";
-            case TokenType::GreaterEqual:   return ">=";
-                // Logical operators
-            case TokenType::And:            return "?+";
-            case TokenType::Or:             return "??";
-            case TokenType::Not:            return "!";
-            case TokenType::Arrow:          return "->";
-            case TokenType::BiArrow:        return "<->";
-            case TokenType::Range:          return "..";
-            case TokenType::DoubleColon:    return "::";
-                // References
-            case TokenType::Ampersand:      return "&";
-            case TokenType::AmpersandAt:    return "&@";
-            case TokenType::Pipe:           return "|";
-                // Punctuation
-            case TokenType::LeftParen:      return "(";
-            case TokenType::RightParen:     return ")";
-            case TokenType::LeftBrace:      return "{";
-            case TokenType::RightBrace:     return "}";
-            case TokenType::LeftBracket:    return "[";
-            case TokenType::RightBracket:   return "]";
-            case TokenType::Comma:          return ",";
-            case TokenType::Semicolon:      return ";";
-            case TokenType::Colon:          return ":";
-            case TokenType::Dot:            return ".";
-                // Special symbols
-            case TokenType::At:             return "@";
-            case TokenType::Hash:           return "#";
-                // End-of-File and Unknown
-            case TokenType::EndOfFile:      return "EOF";
-            case TokenType::Unknown:        return "unknown";
-            default:                        return "invalid";
-            }
+            return std::string(TokenTypeName(type));
         }
 
         std::string literalToString() const {
-            if (std::holds_alternative<int>(literal_))
-                return std::to_string(std::get<int>(literal_));
-            else if (std::holds_alternative<double>(literal_))
-                return std::to_string(std::get<double>(literal_));
-            else if (std::holds_alternative<char>(literal_))
-                return std::string(1, std::get<char>(literal_));
-            else if (std::holds_alternative<std::string>(literal_))
-                return std::get<std::string>(literal_);
+            if (!literal_)
+                return "";
+            if (std::holds_alternative<uint64_t>(*literal_))
+                return std::to_string(std::get<uint64_t>(*literal_));
+            else if (std::holds_alternative<int64_t>(*literal_))
+                return std::to_string(std::get<int64_t>(*literal_));
+            else if (std::holds_alternative<double>(*literal_))
+                return std::to_string(std::get<double>(*literal_));
+            else if (std::holds_alternative<char>(*literal_))
+                return std::string(1, std::get<char>(*literal_));
+            else if (std::holds_alternative<std::string_view>(*literal_))
+                return std::string(std::get<std::string_view>(*literal_));
             return "";
         }
 
-        TokenType type_;
-        std::string lexeme_;
-        TokenLocation location_;
-        TokenLiteral literal_;
+        PackedToken packed_;
+        std::string_view source_;
+        const TokenLiteral* literal_{ nullptr };
     };
 
     //------------------------------------------------------------------------------
-    // 5. The Lexer Class Declaration
+    // 6. The Token Stream
+    //
+    // Struct-of-arrays storage for a tokenized source: a 1-byte kind, a 32-bit offset
+    // and a 32-bit length per token, plus a 32-bit payload: the SymbolId of an
+    // identifier, an index into the stream's (cold) literal pool, or for `[` and `]`
+    // the index of the matching bracket, linked as the tokens are appended. Loops
+    // that only inspect kinds touch one byte per token. The lexemes view the source
+    // buffer, which therefore has to outlive the stream.
+    //------------------------------------------------------------------------------
+    class TokenStream {
+    public:
+        static constexpr uint32_t NoPayload = PackedToken::NoPayload;
+
+        explicit TokenStream(std::string_view source = {})
+            : source_(source) {}
+
+        void reserve(size_t count) {
+            kinds_.reserve(count);
+            offsets_.reserve(count);
+            lengths_.reserve(count);
+            payloads_.reserve(count);
+        }
+
+        // Appends a token scanned from this stream's source. A literal payload must
+        // already index this stream's pool (see literalPool()).
+        void push(const PackedToken& token) {
+            kinds_.push_back(token.getType());
+            offsets_.push_back(token.getOffset());
+            lengths_.push_back(token.getLength());
+            payloads_.push_back(token.getPayload());
+            linkBracket(payloads_.size() - 1);
+        }
+
+        // Appends tokens [from, other.size()) of a stream over the same source.
+        void append(const TokenStream& other, size_t from = 0) {
+            kinds_.insert(kinds_.end(), other.kinds_.begin() + from, other.kinds_.end());
+            offsets_.insert(offsets_.end(), other.offsets_.begin() + from, other.offsets_.end());
+            lengths_.insert(lengths_.end(), other.lengths_.begin() + from, other.lengths_.end());
+            for (size_t i = from; i < other.size(); i++) {
+                if (other.hasLiteral(i))
+                    payloads_.push_back(literals_.add(other.literal(i)));
+                else
+                    payloads_.push_back(other.payloads_[i]);
+                linkBracket(payloads_.size() - 1);
+            }
+            // Keep only the diagnostics raised by the appended tokens.
+            uint32_t firstOffset = from < other.size() ? other.offsets_[from] : UINT32_MAX;
+            for (const Diagnostic& diagnostic : other.diagnostics_) {
+                if (diagnostic.offset >= firstOffset)
+                    diagnostics_.push_back(diagnostic);
+            }
+        }
+
+        // Replaces the tokens with whole arrays, e.g. loaded from the token cache.
+        // Payloads must already be SymbolIds or indices into this stream's pool.
+        void assign(std::vector<TokenType> kinds, std::vector<uint32_t> offsets, std::vector<uint32_t> lengths,
+            std::vector<uint32_t> payloads) {
+            kinds_ = std::move(kinds);
+            offsets_ = std::move(offsets);
+            lengths_ = std::move(lengths);
+            payloads_ = std::move(payloads);
+            linkBrackets();
+        }
+
+        // Incremental relexing (see Relex.cpp): replaces tokens [first, last) with
+        // the first `count` tokens of `replacement`, a stream over the edited source,
+        // and moves the tokens after them by `shift` bytes. Diagnostics in the old
+        // byte range [oldBegin, oldEnd) are replaced the same way.
+        void splice(size_t first, size_t last, const TokenStream& replacement, size_t count,
+            uint32_t oldBegin, uint32_t oldEnd, int64_t shift);
+
+        // Parallel lexing (see ParallelTokenize.cpp): the identifiers from token
+        // `from` on hold ids of `local`; replaces them with ids of `global`,
+        // interning the names in token order, as the serial lexer would.
+        void internSymbols(const Interner& local, Interner& global, size_t from = 0);
+
+        void addDiagnostic(Diagnostic diagnostic) { diagnostics_.push_back(std::move(diagnostic)); }
+        const std::vector<Diagnostic>& diagnostics() const noexcept { return diagnostics_; }
+
+        // The pool the lexer decodes literals into when it fills this stream.
+        LiteralPool& literalPool() noexcept { return literals_; }
+
+        // Hot accessors.
+        size_t size() const noexcept { return kinds_.size(); }
+        bool empty() const noexcept { return kinds_.empty(); }
+        TokenType kind(size_t i) const noexcept { return kinds_[i]; }
+        const std::vector<TokenType>& kinds() const noexcept { return kinds_; }
+        uint32_t offset(size_t i) const noexcept { return offsets_[i]; }
+        const std::vector<uint32_t>& offsets() const noexcept { return offsets_; }
+        uint32_t length(size_t i) const noexcept { return lengths_[i]; }
+        std::string_view lexeme(size_t i) const noexcept { return source_.substr(offsets_[i], lengths_[i]); }
+        std::string_view source() const noexcept { return source_; }
+
+        // Cold accessors.
+        SymbolId symbol(size_t i) const noexcept {
+            return kinds_[i] == TokenType::Identifier ? payloads_[i] : InvalidSymbol;
+        }
+        bool hasLiteral(size_t i) const noexcept {
+            return kinds_[i] != TokenType::Identifier && !IsBracket(kinds_[i]) && payloads_[i] != NoPayload;
+        }
+        // The index of the `]` closing the `[` at i, or of the `[` opening the `]` at
+        // i; NoPayload if it is unbalanced or token i is not a bracket.
+        uint32_t matchingBracket(size_t i) const noexcept {
+            return IsBracket(kinds_[i]) ? payloads_[i] : NoPayload;
+        }
+        const TokenLiteral& literal(size_t i) const noexcept {
+            static const TokenLiteral none;
+            return hasLiteral(i) ? literals_[payloads_[i]] : none;
+        }
+
+        template<typename T>
+        std::optional<T> getLiteral(size_t i) const noexcept {
+            if (auto ptr = std::get_if<T>(&literal(i)))
+                return *ptr;
+            return std::nullopt;
+        }
+
+        // Token i repacked into its 16-byte form.
+        PackedToken packed(size_t i) const noexcept {
+            uint8_t flags = kinds_[i] == TokenType::Identifier ? PackedToken::HasSymbol
+                : hasLiteral(i) ? PackedToken::HasLiteral : 0;
+            return PackedToken(kinds_[i], offsets_[i], lengths_[i], flags, IsBracket(kinds_[i]) ? NoPayload : payloads_[i]);
+        }
+
+        // Adapter for consumers written against GC::Token: a view of token i.
+        Token operator[](size_t i) const noexcept {
+            return Token(packed(i), source_, hasLiteral(i) ? &literals_[payloads_[i]] : nullptr);
+        }
+
+        class Iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = Token;
+            using difference_type = std::ptrdiff_t;
+
+            Iterator(const TokenStream* stream, size_t index) : stream_(stream), index_(index) {}
+            Token operator*() const { return (*stream_)[index_]; }
+            Iterator& operator++() { index_++; return *this; }
+            bool operator==(const Iterator& other) const noexcept { return index_ == other.index_; }
+            bool operator!=(const Iterator& other) const noexcept { return index_ != other.index_; }
+
+        private:
+            const TokenStream* stream_;
+            size_t index_;
+        };
+
+        Iterator begin() const { return Iterator(this, 0); }
+        Iterator end() const { return Iterator(this, size()); }
+
+    private:
+        static bool IsBracket(TokenType type) noexcept {
+            return type == TokenType::LeftBracket || type == TokenType::RightBracket;
+        }
+
+        // Bracket matching as tokens arrive: a `[` waits on openBrackets_ until its
+        // `]` comes, then both payloads point at each other.
+        void linkBracket(size_t i) {
+            if (kinds_[i] == TokenType::LeftBracket) {
+                payloads_[i] = NoPayload;
+                openBrackets_.push_back(static_cast<uint32_t>(i));
+            }
+            else if (kinds_[i] == TokenType::RightBracket) {
+                payloads_[i] = NoPayload;
+                if (!openBrackets_.empty()) {
+                    payloads_[i] = openBrackets_.back();
+                    payloads_[openBrackets_.back()] = static_cast<uint32_t>(i);
+                    openBrackets_.pop_back();
+                }
+            }
+        }
+        // Relinks every bracket, after the arrays were replaced wholesale.
+        void linkBrackets() {
+            openBrackets_.clear();
+            for (size_t i = 0; i < kinds_.size(); i++)
+                linkBracket(i);
+        }
+
+        std::string_view source_;
+        std::vector<TokenType> kinds_;
+        std::vector<uint32_t> offsets_;
+        std::vector<uint32_t> lengths_;
+        std::vector<uint32_t> payloads_;    // SymbolId, index into literals_, matching bracket, or NoPayload.
+        std::vector<uint32_t> openBrackets_;    // `[` tokens not closed yet.
+        LiteralPool literals_;
+        size_t deadLiterals_{ 0 };          // Pool entries no token refers to (after splice()).
+        std::vector<Diagnostic> diagnostics_;
+    };
+
+    //------------------------------------------------------------------------------
+    // 7. The Lexer Class Declaration
     //------------------------------------------------------------------------------
     class Lexer {
     public:
-        explicit Lexer(const std::string& source)
-            : source_(source), position_(0), location_{ 1, 1 } {}
+        // Number of tokens the pull interface can look ahead.
+        static constexpr size_t LookaheadCapacity = 8;
+
+        // The lexer does not copy the source: it must outlive the returned tokens,
+        // and so must `context`, which holds their names, strings and diagnostics.
+        explicit Lexer(std::string_view source, CompilationContext& context = CompilationContext::Global())
+            : source_(source), position_(0), start_(0), context_(context), symbols_(&context.interner())
+            , pulledLiterals_(PulledLiteralSlots), head_(0), buffered_(0) {}
+
+        Lexer(const Lexer&) = delete;
+        Lexer& operator=(const Lexer&) = delete;
+
+        // Hands the counters to the context, which sums them over all lexers.
+        ~Lexer() {
+            if constexpr (LexerStatsEnabled)
+                context_.addLexerStats(stats_);
+        }
 
-        std::vector<Token> tokenize();
+        // Batch interface: lexes the whole source at once.
+        TokenStream tokenize();
+
+        // Chunk interface for parallel lexing: lexes the tokens that start in
+        // [begin, limit) into `tokens` and returns the offset at which the next token
+        // starts. The last token (or comment) may run past `limit`.
+        size_t tokenizeRange(size_t begin, size_t limit, TokenStream& tokens);
+
+        // Interns names into `symbols` rather than the context's interner, so a
+        // chunk lexed out of order numbers its names on its own (see
+        // TokenStream::internSymbols()). `symbols` must outlive the lexer.
+        void internInto(Interner& symbols) noexcept { symbols_ = &symbols; }
+
+        // Pull interface: tokens are produced on demand into a fixed ring buffer, so
+        // lexer memory stays constant whatever the source size. After the last token,
+        // next() keeps returning EndOfFile. A pulled token's literal stays valid for
+        // at least LookaheadCapacity further calls to next().
+        Token next();
+        Token peekToken(size_t k = 0);
+
+        // Diagnostics raised so far by the pull interface (the batch interfaces move
+        // them into the returned stream).
+        const std::vector<Diagnostic>& diagnostics() const noexcept { return diagnostics_; }
+
+        // This lexer's counters so far; all zero unless LEXER_STATS is defined.
+        const LexerStats& stats() const noexcept { return stats_; }
 
     private:
+        // Literal slots of the pull interface: the lookahead window plus as many
+        // tokens already handed out.
+        static constexpr uint32_t PulledLiteralSlots = 2 * LookaheadCapacity;
+
         bool isAtEnd() const { return position_ >= source_.length(); }
         char peek() const { return isAtEnd() ? '\0' : source_[position_]; }
         char peekNext() const { return (position_ + 1 >= source_.length()) ? '\0' : source_[position_ + 1]; }
-        char peekNextN(size_t n) const { return (position_ + n >= source_.length()) ? '\0' : source_[position_ + n]; }
-        char advance();
+        // Locations are derived from offsets on demand, so advancing is a bare increment.
+        char advance() { return source_[position_++]; }
+        PackedToken makeToken(TokenType type) const;
+        PackedToken makeToken(TokenType type, TokenLiteral literal);
+        Token view(const PackedToken& token) const;
+        void report(size_t offset, std::string_view message);
+        void flushDiagnostics(TokenStream& tokens);
+        void validateUtf8(size_t begin, size_t end);
         void skipWhitespaceAndComments();
         void skipLineComment();
         void skipBlockComment();
-        Token scanToken();
-        Token identifierOrKeyword();
-        Token number();
-        Token stringLiteral();
-        Token charLiteral();
+        void skipTriviaCounted();
+        PackedToken scanTokenCounted();
+        PackedToken lexToken();
+        PackedToken scanToken();
+        PackedToken identifierOrKeyword();
+        PackedToken number();
+        PackedToken prefixedNumber(int base);
+        PackedToken stringLiteral();
+        PackedToken charLiteral();
+        bool scanQuoted(char quote);
+        void decodeEscape();
 
-        const std::string& source_;
+        std::string_view source_;
         size_t position_;
-        TokenLocation location_;
+        size_t start_;                  // Offset of the first byte of the token being scanned.
+        std::vector<Diagnostic> diagnostics_;
+        bool validated_{ false };       // The whole source has been checked for UTF-8 errors.
+        CompilationContext& context_;
+        Interner* symbols_;             // The context's interner unless internInto() was called.
+        std::string quoted_;            // Decoded body of the quoted literal being scanned.
+        LexerStats stats_;
+        bool sampling_{ false };        // The current trivia skip and token scan are timed.
+
+        // Where decoded literals go: the stream being filled by the batch
+        // interfaces, or the pull interface's ring when null.
+        LiteralPool* literals_{ nullptr };
+        LiteralPool pulledLiterals_;
+
+        // Lookahead ring buffer for the pull interface.
+        std::array<PackedToken, LookaheadCapacity> lookahead_;
+        size_t head_;
+        size_t buffered_;
+    };
+
+    // Convenience functions. Tokens view the source buffer, so it has to stay alive
+    // (and unmoved) for as long as the tokens are used.
+    TokenStream Tokenize(const CompilationUnit& unit);
+    TokenStream Tokenize(std::string_view source);
+
+    // Parallel variants: large sources are split at line boundaries and lexed on
+    // the pool. The result is identical to the serial lexer's, SymbolIds included.
+    TokenStream Tokenize(const CompilationUnit& unit, ThreadPool& pool);
+    TokenStream Tokenize(std::string_view source, ThreadPool& pool);
+
+    //------------------------------------------------------------------------------
+    // 8. Incremental Relexing
+    //
+    // For editors: after `edit` turned the source of `tokens` into `newSource`, only
+    // the tokens around the edit are relexed, from the last token the edit cannot
+    // have changed until the new tokens line up with the old ones again. The rest of
+    // the stream is kept and shifted, so a keystroke costs a few tokens of lexing
+    // however large the file is. The result is identical to Tokenize(newSource).
+    //------------------------------------------------------------------------------
+    struct TextEdit {
+        uint32_t offset;            // Where the edit starts, in the old source.
+        uint32_t removed;           // Number of bytes removed at `offset`.
+        std::string_view inserted;  // Bytes inserted in their place.
+    };
+
+    // Token indices touched by a relex: [first, first + inserted) in the new stream
+    // replaced [first, first + removed) of the old one.
+    struct RelexResult {
+        size_t first;
+        size_t removed;
+        size_t inserted;
     };
 
-    // A convenience function.
-    std::vector<Token> Tokenize(const std::string& source);
+    RelexResult Relex(TokenStream& tokens, std::string_view newSource, const TextEdit& edit);
 }
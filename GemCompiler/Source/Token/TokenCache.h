@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "Token.h"
+
+namespace GC {
+
+    //------------------------------------------------------------------------------
+    // Token Cache
+    //
+    // Persists the token stream of a source file in a directory shared by compiler
+    // runs, so a file that did not change since the last run is mapped back in
+    // instead of lexed. An entry is named after a hash of the source bytes seeded
+    // with the compiler version and the token table, so editing the file or
+    // upgrading the compiler simply misses. Identifiers are stored by name and
+    // reinterned on load (SymbolIds are per process); literals and diagnostics are
+    // stored with the tokens. Entries are checked before use (header, sizes, a hash
+    // of the body, every index), and anything stale or corrupt is ignored and
+    // rewritten.
+    //------------------------------------------------------------------------------
+    class TokenCache {
+    public:
+        // An empty directory disables the cache: load() misses and store() does nothing.
+        explicit TokenCache(std::string directory)
+            : directory_(std::move(directory)) {}
+
+        // Fills `tokens` (a stream over `source`) from a valid entry and returns true;
+        // names, string literals and diagnostics are copied into `context`.
+        bool load(std::string_view source, TokenStream& tokens,
+            CompilationContext& context = CompilationContext::Global()) const;
+
+        // Writes the entry for `source`; `tokens` must have been lexed with
+        // `context`. Returns false when the entry could not be written.
+        bool store(std::string_view source, const TokenStream& tokens,
+            CompilationContext& context = CompilationContext::Global()) const;
+
+        bool enabled() const noexcept { return !directory_.empty(); }
+        std::string entryPath(std::string_view source) const;
+
+    private:
+        std::string directory_;
+    };
+
+} // namespace GC
@@ -0,0 +1,45 @@
+#include "../Interner.h"
+
+#include <mutex>
+
+namespace GC {
+
+    //------------------------------------------------------------------------------
+    // Look the name up under a shared lock; only new names take the exclusive lock.
+    //------------------------------------------------------------------------------
+    SymbolId Interner::intern(std::string_view name) {
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            auto found = ids_.find(name);
+            if (found != ids_.end())
+                return found->second;
+        }
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        auto found = ids_.find(name); // Another thread may have added it meanwhile.
+        if (found != ids_.end())
+            return found->second;
+        // Key the table on the arena copy, never on the caller's buffer.
+        std::string_view stored = arena_.copy(name);
+        SymbolId id = static_cast<SymbolId>(names_.size());
+        ids_.emplace(stored, id);
+        names_.push_back(stored);
+        return id;
+    }
+
+    std::string_view Interner::name(SymbolId id) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return names_[id];
+    }
+
+    size_t Interner::size() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return names_.size();
+    }
+
+    ArenaStats Interner::arenaStats() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return arena_.stats();
+    }
+
+} // namespace GC
@@ -0,0 +1,123 @@
+#include "../Token.h"
+
+#include <algorithm>
+#include <future>
+#include <memory>
+
+#include "../Simd.h"
+#include "../../Thread/ThreadPool.h"
+
+namespace GC {
+
+    namespace {
+
+        // Below this many bytes per chunk, thread hand-off costs more than it saves.
+        constexpr size_t MinChunkSize = 256 * 1024;
+
+        //------------------------------------------------------------------------------
+        // Split points: one chunk per worker, each starting right after a newline.
+        //------------------------------------------------------------------------------
+        std::vector<size_t> ChunkBoundaries(std::string_view source, size_t chunkCount) {
+            std::vector<size_t> boundaries{ 0 };
+            const char* end = source.data() + source.size();
+            for (size_t k = 1; k < chunkCount; k++) {
+                size_t target = std::max(boundaries.back(), source.size() * k / chunkCount);
+                const char* newline = Simd::FindByte(source.data() + target, end, '\n');
+                if (newline == end)
+                    break;
+                size_t boundary = static_cast<size_t>(newline + 1 - source.data());
+                if (boundary > boundaries.back())
+                    boundaries.push_back(boundary);
+            }
+            boundaries.push_back(source.size());
+            return boundaries;
+        }
+
+        struct Chunk {
+            TokenStream tokens;
+            size_t end;     // Where the chunk's lexer stopped (start of the next token).
+            std::unique_ptr<Interner> symbols;  // Ids of the chunk's identifiers.
+        };
+
+    } // namespace
+
+    //------------------------------------------------------------------------------
+    // Parallel tokenization.
+    //
+    // Every chunk is lexed speculatively, as if it began outside any comment or
+    // literal. Chunks are then stitched in order: if the previous chunk stopped at
+    // offset E, the speculative tokens are kept from the first one that starts
+    // exactly at E, since lexing is deterministic from a token start. A chunk that
+    // never hits E (it began inside a "|-- --|" comment or a string literal) is
+    // relexed serially from E.
+    //
+    // Chunks intern their names into interners of their own, which stitching
+    // renumbers into the context's in token order: SymbolIds are numbered by
+    // first occurrence, as the serial lexer numbers them, whatever the order the
+    // chunks finished in, and names in discarded speculative tokens are dropped.
+    //------------------------------------------------------------------------------
+    TokenStream Tokenize(std::string_view source, ThreadPool& pool) {
+        size_t chunkCount = std::min(pool.size(), source.size() / MinChunkSize);
+        if (chunkCount < 2)
+            return Tokenize(source);
+
+        std::vector<size_t> boundaries = ChunkBoundaries(source, chunkCount);
+        chunkCount = boundaries.size() - 1;
+
+        std::vector<std::future<Chunk>> pending;
+        pending.reserve(chunkCount);
+        for (size_t k = 0; k < chunkCount; k++) {
+            pending.push_back(pool.submit([source, begin = boundaries[k], limit = boundaries[k + 1]] {
+                Chunk chunk{ TokenStream(source), 0, std::make_unique<Interner>() };
+                Lexer lexer(source);
+                lexer.internInto(*chunk.symbols);
+                chunk.end = lexer.tokenizeRange(begin, limit, chunk.tokens);
+                return chunk;
+            }));
+        }
+
+        TokenStream tokens(source);
+        size_t resume = 0;
+        for (size_t k = 0; k < chunkCount; k++) {
+            Chunk chunk = pending[k].get();
+
+            // The previous chunk already consumed this one entirely.
+            if (resume >= chunk.end)
+                continue;
+
+            const std::vector<uint32_t>& offsets = chunk.tokens.offsets();
+            auto sync = std::lower_bound(offsets.begin(), offsets.end(), static_cast<uint32_t>(resume));
+            if (sync != offsets.end() && *sync == resume) {
+                const size_t from = static_cast<size_t>(sync - offsets.begin());
+                chunk.tokens.internSymbols(*chunk.symbols, CompilationContext::Global().interner(), from);
+                tokens.append(chunk.tokens, from);
+                resume = chunk.end;
+            }
+            else {
+                // Speculation failed: relex from where the previous chunk really ended.
+                Lexer lexer(source);
+                resume = lexer.tokenizeRange(resume, boundaries[k + 1], tokens);
+            }
+        }
+
+        tokens.push(PackedToken(TokenType::EndOfFile, static_cast<uint32_t>(source.size()), 0));
+        return tokens;
+    }
+
+    void TokenStream::internSymbols(const Interner& local, Interner& global, size_t from) {
+        std::vector<SymbolId> ids(local.size(), InvalidSymbol);
+        for (size_t i = from; i < size(); i++) {
+            if (kinds_[i] != TokenType::Identifier)
+                continue;
+            SymbolId& id = ids[payloads_[i]];
+            if (id == InvalidSymbol)
+                id = global.intern(local.name(payloads_[i]));
+            payloads_[i] = id;
+        }
+    }
+
+    TokenStream Tokenize(const CompilationUnit& unit, ThreadPool& pool) {
+        return Tokenize(unit.getSource(), pool);
+    }
+
+} // namespace GC
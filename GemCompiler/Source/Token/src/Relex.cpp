@@ -0,0 +1,163 @@
+#include "../Token.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "../Operators.h"
+
+namespace GC {
+
+    namespace {
+
+        // Bytes the lexer may read past the end of a token before committing to it:
+        // the operator machine backs off from a partial match of its longest pattern,
+        // a number peeks two bytes to tell "1.5" from "1..", and an identifier decodes
+        // a whole UTF-8 sequence to see whether it continues. A token is only kept
+        // when the edit starts beyond this window.
+        constexpr size_t MaxUtf8Length = 4;
+        constexpr size_t MaxLookahead = [] {
+            size_t longest = 0;
+            for (const OperatorDfa::Pattern& pattern : OperatorDfa::Patterns)
+                longest = std::max(longest, pattern.text.size());
+            return std::max({ longest - 1, size_t{ 2 }, MaxUtf8Length });
+        }();
+
+        // First relex window; doubled until the new tokens resynchronize.
+        constexpr size_t InitialWindow = 256;
+
+        // Replaces values[first, last) with [begin, end).
+        template<typename T, typename It>
+        void Replace(std::vector<T>& values, size_t first, size_t last, It begin, It end) {
+            size_t count = static_cast<size_t>(end - begin);
+            size_t removed = last - first;
+            if (count > removed)
+                values.insert(values.begin() + last, count - removed, T{});
+            else
+                values.erase(values.begin() + first + count, values.begin() + last);
+            std::copy(begin, end, values.begin() + first);
+        }
+
+    } // namespace
+
+    //------------------------------------------------------------------------------
+    // Splice the relexed tokens into the stream.
+    //------------------------------------------------------------------------------
+    void TokenStream::splice(size_t first, size_t last, const TokenStream& replacement, size_t count,
+        uint32_t oldBegin, uint32_t oldEnd, int64_t shift)
+    {
+        // Literals of the removed tokens stay in the pool until enough of them pile
+        // up, then the pool is rebuilt from the live tokens.
+        for (size_t i = first; i < last; i++)
+            deadLiterals_ += hasLiteral(i);
+
+        std::vector<uint32_t> payloads(replacement.payloads_.begin(), replacement.payloads_.begin() + count);
+        for (size_t i = 0; i < count; i++) {
+            if (replacement.hasLiteral(i))
+                payloads[i] = literals_.add(replacement.literal(i));
+        }
+
+        Replace(kinds_, first, last, replacement.kinds_.begin(), replacement.kinds_.begin() + count);
+        Replace(offsets_, first, last, replacement.offsets_.begin(), replacement.offsets_.begin() + count);
+        Replace(lengths_, first, last, replacement.lengths_.begin(), replacement.lengths_.begin() + count);
+        Replace(payloads_, first, last, payloads.begin(), payloads.end());
+
+        // Offsets are unsigned, so adding the two's complement of a negative shift
+        // moves them back.
+        const uint32_t delta = static_cast<uint32_t>(shift);
+        for (size_t i = first + count; i < offsets_.size(); i++)
+            offsets_[i] += delta;
+
+        // Token indices after the edit moved, and the edit may have opened or
+        // closed brackets anywhere.
+        linkBrackets();
+
+        // Diagnostics stay in source order: those before the relexed range, the
+        // relexed range's, then the shifted rest.
+        const uint32_t newEnd = oldEnd + delta;
+        std::vector<Diagnostic> diagnostics;
+        diagnostics.reserve(diagnostics_.size());
+        for (Diagnostic& diagnostic : diagnostics_) {
+            if (diagnostic.offset < oldBegin)
+                diagnostics.push_back(std::move(diagnostic));
+        }
+        for (const Diagnostic& diagnostic : replacement.diagnostics_) {
+            if (diagnostic.offset >= oldBegin && diagnostic.offset < newEnd)
+                diagnostics.push_back(diagnostic);
+        }
+        for (Diagnostic& diagnostic : diagnostics_) {
+            if (diagnostic.offset >= oldEnd) {
+                diagnostic.offset += delta;
+                diagnostics.push_back(std::move(diagnostic));
+            }
+        }
+        diagnostics_ = std::move(diagnostics);
+        source_ = replacement.source_;
+
+        if (deadLiterals_ > 64 && deadLiterals_ > literals_.size() / 2) {
+            LiteralPool live;
+            for (size_t i = 0; i < size(); i++) {
+                if (hasLiteral(i))
+                    payloads_[i] = live.add(literals_[payloads_[i]]);
+            }
+            literals_ = std::move(live);
+            deadLiterals_ = 0;
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    // Incremental relexing.
+    //
+    // Lexing is deterministic from a token start, so once a new token starts past
+    // the edit at the (shifted) start of an old token, everything after it is the
+    // same as before. Block comments and string literals need no special case: an
+    // edit inside one restarts before its opener (trivia and literals never
+    // contain a token start), and an edit that opens or closes one simply keeps the
+    // relex going until the streams agree again, at the latest at EndOfFile.
+    //------------------------------------------------------------------------------
+    RelexResult Relex(TokenStream& tokens, std::string_view newSource, const TextEdit& edit) {
+        assert(!tokens.empty() && tokens.kind(tokens.size() - 1) == TokenType::EndOfFile);
+        const int64_t shift = static_cast<int64_t>(edit.inserted.size()) - static_cast<int64_t>(edit.removed);
+        assert(static_cast<int64_t>(newSource.size()) == static_cast<int64_t>(tokens.source().size()) + shift);
+        const size_t editEnd = edit.offset + edit.inserted.size();     // In the new source.
+
+        // Restart after the last token the lexer decided without looking at the edit.
+        const std::vector<uint32_t>& offsets = tokens.offsets();
+        size_t first = static_cast<size_t>(std::lower_bound(offsets.begin(), offsets.end(), edit.offset) - offsets.begin());
+        while (first > 0 && offsets[first - 1] + tokens.length(first - 1) + MaxLookahead > edit.offset)
+            first--;
+        const uint32_t restart = first > 0 ? offsets[first - 1] + tokens.length(first - 1) : 0;
+
+        // Relex in growing windows until a new token lines up with an old one.
+        TokenStream fresh(newSource);
+        Lexer lexer(newSource);
+        size_t position = restart;
+        size_t window = InitialWindow;
+        size_t candidate = first;   // First old token that may still match.
+        size_t count = 0;           // Fresh tokens before the sync point.
+        size_t last = tokens.size() - 1;
+        for (bool synced = false; !synced;) {
+            position = lexer.tokenizeRange(position, std::min(newSource.size(), position + window), fresh);
+            for (; count < fresh.size(); count++) {
+                uint32_t start = fresh.offset(count);
+                if (start < editEnd)
+                    continue;
+                int64_t oldStart = static_cast<int64_t>(start) - shift;
+                while (candidate < tokens.size() && offsets[candidate] < oldStart)
+                    candidate++;
+                if (candidate < tokens.size() && offsets[candidate] == oldStart) {
+                    last = candidate;
+                    synced = true;
+                    break;
+                }
+            }
+            // At the end of the source the old EndOfFile token is the sync point.
+            if (position >= newSource.size())
+                synced = true;
+            window *= 2;
+        }
+
+        tokens.splice(first, last, fresh, count, restart, offsets[last], shift);
+        return RelexResult{ first, last - first, count };
+    }
+
+} // namespace GC
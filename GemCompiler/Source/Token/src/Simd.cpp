@@ -0,0 +1,491 @@
+#include "../Simd.h"
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#include "../CharClass.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define GC_SIMD_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        #define GC_TARGET_AVX2
+    #else
+        #define GC_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#endif
+
+namespace GC::Simd {
+
+    namespace {
+
+        //------------------------------------------------------------------------------
+        // Scalar kernels (also used for the tails of the vector kernels).
+        //------------------------------------------------------------------------------
+        const char* SkipSpacesScalar(const char* p, const char* end) noexcept {
+            while (p < end && IsSpace(*p))
+                p++;
+            return p;
+        }
+
+        const char* FindByteScalar(const char* p, const char* end, char c) noexcept {
+            if (p >= end)
+                return end;
+            const void* hit = std::memchr(p, c, static_cast<size_t>(end - p));
+            return hit ? static_cast<const char*>(hit) : end;
+        }
+
+        const char* FindEitherByteScalar(const char* p, const char* end, char a, char b) noexcept {
+            for (; p < end; p++) {
+                if (*p == a || *p == b)
+                    return p;
+            }
+            return end;
+        }
+
+        const char* FindBlockCommentEndScalar(const char* p, const char* end) noexcept {
+            for (; end - p >= 3; p++) {
+                if (p[0] == '-' && p[1] == '-' && p[2] == '|')
+                    return p;
+            }
+            return end;
+        }
+
+        size_t CountNewlinesScalar(const char* p, const char* end) noexcept {
+            size_t count = 0;
+            for (; p < end; p++)
+                count += *p == '\n';
+            return count;
+        }
+
+        const char* ValidateUtf8Scalar(const char* p, const char* end) noexcept {
+            while (p < end) {
+                // Eight ASCII bytes at a time.
+                uint64_t word;
+                if (end - p >= 8 && (std::memcpy(&word, p, 8), (word & 0x8080808080808080ull) == 0)) {
+                    p += 8;
+                    continue;
+                }
+                char32_t codePoint;
+                int length = CharClass::DecodeUtf8(p, end, codePoint);
+                if (length == 0)
+                    return p;
+                p += length;
+            }
+            return end;
+        }
+
+        // Start of the sequence that a vector block starting at `p` may have cut:
+        // the scalar validator resumes there to find the exact offending byte.
+        const char* SequenceStart(const char* begin, const char* p) noexcept {
+            const char* q = p;
+            while (q > begin && p - q < 3 && (static_cast<unsigned char>(q[-1]) & 0xC0) == 0x80)
+                q--;
+            if (q > begin && static_cast<unsigned char>(q[-1]) >= 0xC0)
+                q--;
+            return q;
+        }
+
+#if GC_SIMD_X86
+        //------------------------------------------------------------------------------
+        // SSE2 kernels: 16 bytes per step. SSE2 is part of the x86-64 baseline.
+        //------------------------------------------------------------------------------
+        inline __m128i Load16(const char* p) {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        }
+
+        inline uint32_t SpaceMask16(__m128i v) {
+            // ' ' or a byte in [\t, \r]: (v - 9) <= 4 as an unsigned compare.
+            __m128i shifted = _mm_sub_epi8(v, _mm_set1_epi8(9));
+            __m128i isControl = _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8(4)), shifted);
+            __m128i isSpace = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), isControl);
+            return static_cast<uint32_t>(_mm_movemask_epi8(isSpace));
+        }
+
+        const char* SkipSpacesSse2(const char* p, const char* end) noexcept {
+            for (; end - p >= 16; p += 16) {
+                uint32_t other = ~SpaceMask16(Load16(p)) & 0xFFFFu;
+                if (other)
+                    return p + std::countr_zero(other);
+            }
+            return SkipSpacesScalar(p, end);
+        }
+
+        const char* FindByteSse2(const char* p, const char* end, char c) noexcept {
+            const __m128i needle = _mm_set1_epi8(c);
+            for (; end - p >= 16; p += 16) {
+                uint32_t hits = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(Load16(p), needle)));
+                if (hits)
+                    return p + std::countr_zero(hits);
+            }
+            return FindByteScalar(p, end, c);
+        }
+
+        const char* FindEitherByteSse2(const char* p, const char* end, char a, char b) noexcept {
+            const __m128i first = _mm_set1_epi8(a);
+            const __m128i second = _mm_set1_epi8(b);
+            for (; end - p >= 16; p += 16) {
+                __m128i v = Load16(p);
+                __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(v, first), _mm_cmpeq_epi8(v, second));
+                uint32_t hits = static_cast<uint32_t>(_mm_movemask_epi8(hit));
+                if (hits)
+                    return p + std::countr_zero(hits);
+            }
+            return FindEitherByteScalar(p, end, a, b);
+        }
+
+        const char* FindBlockCommentEndSse2(const char* p, const char* end) noexcept {
+            const __m128i dash = _mm_set1_epi8('-');
+            const __m128i pipe = _mm_set1_epi8('|');
+            for (; end - p >= 18; p += 16) {
+                __m128i first = _mm_cmpeq_epi8(Load16(p), dash);
+                __m128i second = _mm_cmpeq_epi8(Load16(p + 1), dash);
+                __m128i third = _mm_cmpeq_epi8(Load16(p + 2), pipe);
+                uint32_t hits = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_and_si128(first, second), third)));
+                if (hits)
+                    return p + std::countr_zero(hits);
+            }
+            return FindBlockCommentEndScalar(p, end);
+        }
+
+        size_t CountNewlinesSse2(const char* p, const char* end) noexcept {
+            const __m128i newline = _mm_set1_epi8('\n');
+            size_t count = 0;
+            for (; end - p >= 16; p += 16)
+                count += std::popcount(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(Load16(p), newline))));
+            return count + CountNewlinesScalar(p, end);
+        }
+
+        // ASCII blocks are skipped 16 bytes at a time; multi-byte sequences are
+        // checked one by one.
+        const char* ValidateUtf8Sse2(const char* p, const char* end) noexcept {
+            while (end - p >= 16) {
+                uint32_t high = static_cast<uint32_t>(_mm_movemask_epi8(Load16(p)));
+                if (high == 0) {
+                    p += 16;
+                    continue;
+                }
+                p += std::countr_zero(high);
+                char32_t codePoint;
+                int length = CharClass::DecodeUtf8(p, end, codePoint);
+                if (length == 0)
+                    return p;
+                p += length;
+            }
+            return ValidateUtf8Scalar(p, end);
+        }
+
+        //------------------------------------------------------------------------------
+        // AVX2 kernels: 32 bytes per step, only called after a runtime CPU check.
+        //------------------------------------------------------------------------------
+        GC_TARGET_AVX2 inline __m256i Load32(const char* p) {
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        }
+
+        GC_TARGET_AVX2 const char* SkipSpacesAvx2(const char* p, const char* end) noexcept {
+            const __m256i nine = _mm256_set1_epi8(9);
+            const __m256i four = _mm256_set1_epi8(4);
+            const __m256i space = _mm256_set1_epi8(' ');
+            for (; end - p >= 32; p += 32) {
+                __m256i v = Load32(p);
+                __m256i shifted = _mm256_sub_epi8(v, nine);
+                __m256i isControl = _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, four), shifted);
+                __m256i isSpace = _mm256_or_si256(_mm256_cmpeq_epi8(v, space), isControl);
+                uint32_t other = ~static_cast<uint32_t>(_mm256_movemask_epi8(isSpace));
+                if (other)
+                    return p + std::countr_zero(other);
+            }
+            return SkipSpacesSse2(p, end);
+        }
+
+        GC_TARGET_AVX2 const char* FindByteAvx2(const char* p, const char* end, char c) noexcept {
+            const __m256i needle = _mm256_set1_epi8(c);
+            for (; end - p >= 32; p += 32) {
+                uint32_t hits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(Load32(p), needle)));
+                if (hits)
+                    return p + std::countr_zero(hits);
+            }
+            return FindByteSse2(p, end, c);
+        }
+
+        GC_TARGET_AVX2 const char* FindEitherByteAvx2(const char* p, const char* end, char a, char b) noexcept {
+            const __m256i first = _mm256_set1_epi8(a);
+            const __m256i second = _mm256_set1_epi8(b);
+            for (; end - p >= 32; p += 32) {
+                __m256i v = Load32(p);
+                __m256i hit = _mm256_or_si256(_mm256_cmpeq_epi8(v, first), _mm256_cmpeq_epi8(v, second));
+                uint32_t hits = static_cast<uint32_t>(_mm256_movemask_epi8(hit));
+                if (hits)
+                    return p + std::countr_zero(hits);
+            }
+            return FindEitherByteSse2(p, end, a, b);
+        }
+
+        GC_TARGET_AVX2 const char* FindBlockCommentEndAvx2(const char* p, const char* end) noexcept {
+            const __m256i dash = _mm256_set1_epi8('-');
+            const __m256i pipe = _mm256_set1_epi8('|');
+            for (; end - p >= 34; p += 32) {
+                __m256i first = _mm256_cmpeq_epi8(Load32(p), dash);
+                __m256i second = _mm256_cmpeq_epi8(Load32(p + 1), dash);
+                __m256i third = _mm256_cmpeq_epi8(Load32(p + 2), pipe);
+                uint32_t hits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_and_si256(first, second), third)));
+                if (hits)
+                    return p + std::countr_zero(hits);
+            }
+            return FindBlockCommentEndSse2(p, end);
+        }
+
+        GC_TARGET_AVX2 size_t CountNewlinesAvx2(const char* p, const char* end) noexcept {
+            const __m256i newline = _mm256_set1_epi8('\n');
+            size_t count = 0;
+            for (; end - p >= 32; p += 32)
+                count += std::popcount(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(Load32(p), newline))));
+            return count + CountNewlinesSse2(p, end);
+        }
+
+        //------------------------------------------------------------------------------
+        // AVX2 UTF-8 validation: the "lookup" algorithm of Keiser and Lemire,
+        // "Validating UTF-8 In Less Than One Instruction Per Byte" (2021). Three
+        // 16-entry tables indexed by nibbles of each byte and its predecessor flag
+        // every malformed two-byte pattern; a saturating compare checks that the
+        // third and fourth bytes of long sequences are continuations.
+        //------------------------------------------------------------------------------
+        namespace Utf8 {
+            constexpr uint8_t TooShort    = 1 << 0;
+            constexpr uint8_t TooLong     = 1 << 1;
+            constexpr uint8_t Overlong3   = 1 << 2;
+            constexpr uint8_t TooLarge    = 1 << 3;
+            constexpr uint8_t Surrogate   = 1 << 4;
+            constexpr uint8_t Overlong2   = 1 << 5;
+            constexpr uint8_t TooLarge1000 = 1 << 6;
+            constexpr uint8_t Overlong4   = 1 << 6;
+            constexpr uint8_t TwoConts    = 1 << 7;
+            constexpr uint8_t Carry       = TooShort | TooLong | TwoConts;
+        }
+
+        GC_TARGET_AVX2 inline __m256i Lookup16(__m256i index,
+            uint8_t t0, uint8_t t1, uint8_t t2, uint8_t t3, uint8_t t4, uint8_t t5, uint8_t t6, uint8_t t7,
+            uint8_t t8, uint8_t t9, uint8_t t10, uint8_t t11, uint8_t t12, uint8_t t13, uint8_t t14, uint8_t t15)
+        {
+            const __m256i table = _mm256_setr_epi8(
+                t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, t10, t11, t12, t13, t14, t15,
+                t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, t10, t11, t12, t13, t14, t15);
+            return _mm256_shuffle_epi8(table, index);
+        }
+
+        GC_TARGET_AVX2 inline __m256i HighNibbles(__m256i v) {
+            return _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0F));
+        }
+
+        // The input shifted by N bytes, pulling the last N bytes of `previous` in.
+        template<int N>
+        GC_TARGET_AVX2 inline __m256i Previous(__m256i input, __m256i previous) {
+            return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(previous, input, 0x21), 16 - N);
+        }
+
+        GC_TARGET_AVX2 inline __m256i Utf8Errors(__m256i input, __m256i previous) {
+            using namespace Utf8;
+            const __m256i prev1 = Previous<1>(input, previous);
+            const __m256i byte1High = Lookup16(HighNibbles(prev1),
+                TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong,
+                TwoConts, TwoConts, TwoConts, TwoConts,
+                TooShort | Overlong2,
+                TooShort,
+                TooShort | Overlong3 | Surrogate,
+                TooShort | TooLarge | TooLarge1000 | Overlong4);
+            const __m256i byte1Low = Lookup16(_mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)),
+                Carry | Overlong3 | Overlong2 | Overlong4,
+                Carry | Overlong2,
+                Carry,
+                Carry,
+                Carry | TooLarge,
+                Carry | TooLarge | TooLarge1000,
+                Carry | TooLarge | TooLarge1000,
+                Carry | TooLarge | TooLarge1000,
+                Carry | TooLarge | TooLarge1000,
+                Carry | TooLarge | TooLarge1000,
+                Carry | TooLarge | TooLarge1000,
+                Carry | TooLarge | TooLarge1000,
+                Carry | TooLarge | TooLarge1000,
+                Carry | TooLarge | TooLarge1000 | Surrogate,
+                Carry | TooLarge | TooLarge1000,
+                Carry | TooLarge | TooLarge1000);
+            const __m256i byte2High = Lookup16(HighNibbles(input),
+                TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort,
+                TooLong | Overlong2 | TwoConts | Overlong3 | TooLarge1000 | Overlong4,
+                TooLong | Overlong2 | TwoConts | Overlong3 | TooLarge,
+                TooLong | Overlong2 | TwoConts | Surrogate | TooLarge,
+                TooLong | Overlong2 | TwoConts | Surrogate | TooLarge,
+                TooShort, TooShort, TooShort, TooShort);
+            const __m256i special = _mm256_and_si256(_mm256_and_si256(byte1High, byte1Low), byte2High);
+
+            // Bytes 2 and 3 positions after a 3- or 4-byte lead must be continuations.
+            const __m256i third = _mm256_subs_epu8(Previous<2>(input, previous), _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+            const __m256i fourth = _mm256_subs_epu8(Previous<3>(input, previous), _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+            const __m256i mustContinue = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(static_cast<char>(0x80)));
+            return _mm256_xor_si256(mustContinue, special);
+        }
+
+        // Non-zero where a block ends inside a multi-byte sequence.
+        GC_TARGET_AVX2 inline __m256i Utf8Incomplete(__m256i input) {
+            const __m256i maxValue = _mm256_setr_epi8(
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+            return _mm256_subs_epu8(input, maxValue);
+        }
+
+        // Checks one block; false when it (or a sequence it ends) is malformed.
+        GC_TARGET_AVX2 inline bool Utf8Block(__m256i input, __m256i& previous, __m256i& incomplete) {
+            __m256i error = incomplete;
+            if (_mm256_movemask_epi8(input) != 0) {
+                error = Utf8Errors(input, previous);
+                incomplete = Utf8Incomplete(input);
+            }
+            previous = input;
+            return _mm256_testz_si256(error, error) != 0;
+        }
+
+        GC_TARGET_AVX2 const char* ValidateUtf8Avx2(const char* begin, const char* end) noexcept {
+            __m256i previous = _mm256_setzero_si256();
+            __m256i incomplete = _mm256_setzero_si256();
+            const char* p = begin;
+            for (; end - p >= 32; p += 32) {
+                if (!Utf8Block(Load32(p), previous, incomplete))
+                    return ValidateUtf8Scalar(SequenceStart(begin, p), end);
+            }
+            // Zero padding is ASCII, so a sequence cut by `end` shows up as too short.
+            alignas(32) char tail[32] = {};
+            if (p < end)
+                std::memcpy(tail, p, static_cast<size_t>(end - p));
+            if (!Utf8Block(_mm256_load_si256(reinterpret_cast<const __m256i*>(tail)), previous, incomplete))
+                return ValidateUtf8Scalar(SequenceStart(begin, p), end);
+            return end;
+        }
+
+        bool CpuHasAvx2() noexcept {
+#if defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7)
+                return false;
+            __cpuid(info, 1);
+            bool osxsave = (info[2] & (1 << 27)) != 0;
+            if (!osxsave || (_xgetbv(0) & 0x6) != 0x6)
+                return false;
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+#else
+            return __builtin_cpu_supports("avx2");
+#endif
+        }
+#endif // GC_SIMD_X86
+
+        //------------------------------------------------------------------------------
+        // Dispatch table.
+        //------------------------------------------------------------------------------
+        std::atomic<Isa>& ActiveSlot() noexcept {
+            static std::atomic<Isa> active{ DetectIsa() };
+            return active;
+        }
+
+    } // namespace
+
+    Isa DetectIsa() noexcept {
+#if GC_SIMD_X86
+        static const Isa detected = CpuHasAvx2() ? Isa::Avx2 : Isa::Sse2;
+        return detected;
+#else
+        return Isa::Scalar;
+#endif
+    }
+
+    Isa ActiveIsa() noexcept {
+        return ActiveSlot().load(std::memory_order_relaxed);
+    }
+
+    void UseIsa(Isa isa) noexcept {
+        if (isa > DetectIsa())
+            isa = DetectIsa();
+        ActiveSlot().store(isa, std::memory_order_relaxed);
+    }
+
+    const char* IsaName(Isa isa) noexcept {
+        switch (isa) {
+        case Isa::Scalar: return "scalar";
+        case Isa::Sse2:   return "sse2";
+        case Isa::Avx2:   return "avx2";
+        default:          return "invalid";
+        }
+    }
+
+    const char* SkipSpaces(const char* begin, const char* end) noexcept {
+#if GC_SIMD_X86
+        switch (ActiveIsa()) {
+        case Isa::Avx2: return SkipSpacesAvx2(begin, end);
+        case Isa::Sse2: return SkipSpacesSse2(begin, end);
+        default:        break;
+        }
+#endif
+        return SkipSpacesScalar(begin, end);
+    }
+
+    const char* FindByte(const char* begin, const char* end, char c) noexcept {
+#if GC_SIMD_X86
+        switch (ActiveIsa()) {
+        case Isa::Avx2: return FindByteAvx2(begin, end, c);
+        case Isa::Sse2: return FindByteSse2(begin, end, c);
+        default:        break;
+        }
+#endif
+        return FindByteScalar(begin, end, c);
+    }
+
+    const char* FindEitherByte(const char* begin, const char* end, char a, char b) noexcept {
+#if GC_SIMD_X86
+        switch (ActiveIsa()) {
+        case Isa::Avx2: return FindEitherByteAvx2(begin, end, a, b);
+        case Isa::Sse2: return FindEitherByteSse2(begin, end, a, b);
+        default:        break;
+        }
+#endif
+        return FindEitherByteScalar(begin, end, a, b);
+    }
+
+    const char* FindBlockCommentEnd(const char* begin, const char* end) noexcept {
+#if GC_SIMD_X86
+        switch (ActiveIsa()) {
+        case Isa::Avx2: return FindBlockCommentEndAvx2(begin, end);
+        case Isa::Sse2: return FindBlockCommentEndSse2(begin, end);
+        default:        break;
+        }
+#endif
+        return FindBlockCommentEndScalar(begin, end);
+    }
+
+    const char* ValidateUtf8(const char* begin, const char* end) noexcept {
+#if GC_SIMD_X86
+        switch (ActiveIsa()) {
+        case Isa::Avx2: return ValidateUtf8Avx2(begin, end);
+        case Isa::Sse2: return ValidateUtf8Sse2(begin, end);
+        default:        break;
+        }
+#endif
+        return ValidateUtf8Scalar(begin, end);
+    }
+
+    size_t CountNewlines(const char* begin, const char* end) noexcept {
+#if GC_SIMD_X86
+        switch (ActiveIsa()) {
+        case Isa::Avx2: return CountNewlinesAvx2(begin, end);
+        case Isa::Sse2: return CountNewlinesSse2(begin, end);
+        default:        break;
+        }
+#endif
+        return CountNewlinesScalar(begin, end);
+    }
+
+} // namespace GC::Simd
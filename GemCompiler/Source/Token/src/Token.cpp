@@ -1,28 +1,85 @@
 #include "../Token.h"
 
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <chrono>
+
+#include "../CharClass.h"
+#include "../Keywords.h"
+#include "../Operators.h"
+#include "../Simd.h"
+
 namespace GC {
 
     //------------------------------------------------------------------------------
-    // Utility: Advance the current position and update location.
+    // Two uppercase hex digits, for diagnostics about raw bytes.
     //------------------------------------------------------------------------------
-    char Lexer::advance() {
-        char c = source_[position_++];
-        if (c == '\n') {
-            location_.line++;
-            location_.column = 1;
-        }
-        else {
-            location_.column++;
-        }
-        return c;
+    static std::string HexByte(unsigned char byte) {
+        const char* digits = "0123456789ABCDEF";
+        return { digits[byte >> 4], digits[byte & 0x0F] };
+    }
+
+    //------------------------------------------------------------------------------
+    // Build a token whose lexeme spans from the token start to the current position.
+    //------------------------------------------------------------------------------
+    PackedToken Lexer::makeToken(TokenType type) const {
+        return PackedToken(type, static_cast<uint32_t>(start_), static_cast<uint32_t>(position_ - start_));
+    }
+
+    PackedToken Lexer::makeToken(TokenType type, TokenLiteral literal) {
+        LiteralPool& pool = literals_ ? *literals_ : pulledLiterals_;
+        return PackedToken(type, static_cast<uint32_t>(start_), static_cast<uint32_t>(position_ - start_),
+            PackedToken::HasLiteral, pool.add(std::move(literal)));
+    }
+
+    //------------------------------------------------------------------------------
+    // View of a token produced by the pull interface.
+    //------------------------------------------------------------------------------
+    Token Lexer::view(const PackedToken& token) const {
+        return Token(token, source_, token.hasLiteral() ? &pulledLiterals_[token.getPayload()] : nullptr);
+    }
+
+    //------------------------------------------------------------------------------
+    // Diagnostics are collected here and handed over to the token stream. Their
+    // text is kept in the context's arena. UTF-8 errors are found ahead of the
+    // tokens around them, so each one is inserted in source order.
+    //------------------------------------------------------------------------------
+    void Lexer::report(size_t offset, std::string_view message) {
+        Diagnostic diagnostic{ Diagnostic::Severity::Error, static_cast<uint32_t>(offset), context_.storeMessage(message) };
+        auto position = std::upper_bound(diagnostics_.begin(), diagnostics_.end(), diagnostic,
+            [](const Diagnostic& a, const Diagnostic& b) { return a.offset < b.offset; });
+        diagnostics_.insert(position, diagnostic);
+    }
+
+    void Lexer::flushDiagnostics(TokenStream& tokens) {
+        for (const Diagnostic& diagnostic : diagnostics_)
+            tokens.addDiagnostic(diagnostic);
+        diagnostics_.clear();
+    }
+
+    //------------------------------------------------------------------------------
+    // Reports every malformed UTF-8 sequence in [begin, end). The scan is SIMD and
+    // runs once over the input, so the lexer itself can assume well-formed text
+    // everywhere except at the reported offsets.
+    //------------------------------------------------------------------------------
+    void Lexer::validateUtf8(size_t begin, size_t end) {
+        const char* base = source_.data();
+        const char* stop = base + end;
+        // Every bad byte is reported on its own, like the Unknown token it becomes,
+        // so that validating any range that starts at a token gives the same result.
+        for (const char* p = base + begin; (p = Simd::ValidateUtf8(p, stop)) != stop; p++)
+            report(static_cast<size_t>(p - base), "invalid UTF-8 byte 0x" + HexByte(static_cast<unsigned char>(*p)));
+        if (begin == 0 && end == source_.size())
+            validated_ = true;
     }
 
     //------------------------------------------------------------------------------
     // Skip a single-line comment starting with "||"
     //------------------------------------------------------------------------------
     void Lexer::skipLineComment() {
-        while (!isAtEnd() && peek() != '\n')
-            advance();
+        const char* end = source_.data() + source_.size();
+        position_ = Simd::FindByte(source_.data() + position_, end, '\n') - source_.data();
     }
 
     //------------------------------------------------------------------------------
@@ -30,42 +87,40 @@ namespace GC {
     //------------------------------------------------------------------------------
     void Lexer::skipBlockComment() {
         // We assume the initial "|--" has already been consumed.
-        while (!isAtEnd()) {
-            // Look for the end marker "--|"
-            if (peek() == '-' && peekNext() == '-' && peekNextN(2) == '|') {
-                // Consume the "--|"
-                advance(); // '-'
-                advance(); // '-'
-                advance(); // '|'
-                break;
-            }
-            advance();
-        }
+        const char* end = source_.data() + source_.size();
+        const char* terminator = Simd::FindBlockCommentEnd(source_.data() + position_, end);
+        // Consume the "--|" as well, or run to the end of an unterminated comment.
+        position_ = (terminator == end ? end : terminator + 3) - source_.data();
     }
 
     //------------------------------------------------------------------------------
     // Skip whitespace and comments.
     //------------------------------------------------------------------------------
     void Lexer::skipWhitespaceAndComments() {
+        const char* end = source_.data() + source_.size();
         while (!isAtEnd()) {
             char c = peek();
-            if (std::isspace(c)) {
-                advance();
+            if (Simd::IsSpace(c)) {
+                position_ = Simd::SkipSpaces(source_.data() + position_, end) - source_.data();
             }
-            // Check for line comment marker "||"
-            else if (c == '|' && peekNext() == '|') {
-                // Consume "||" and then skip until end-of-line.
-                advance(); // '|'
-                advance(); // '|'
-                skipLineComment();
-            }
-            // Check for block comment marker "|--"
-            else if (c == '|' && peekNext() == '-' && peekNextN(2) == '-') {
-                // Consume "|--"
-                advance(); // '|'
-                advance(); // '-'
-                advance(); // '-'
-                skipBlockComment();
+            else if (OperatorDfa::TriviaStarts[static_cast<unsigned char>(c)]) {
+                // "||" and "|--" share a prefix with the "|" operator: let the
+                // operator machine decide, and only consume a comment opener.
+                OperatorMatch match = MatchOperator(source_.data() + position_, end);
+                const size_t opener = position_;
+                if (match.accept == OperatorDfa::LineCommentOpener) {
+                    position_ += match.length;
+                    skipLineComment();
+                }
+                else if (match.accept == OperatorDfa::BlockCommentOpener) {
+                    position_ += match.length;
+                    skipBlockComment();
+                }
+                else {
+                    break;
+                }
+                if constexpr (LexerStatsEnabled)
+                    stats_.commentBytes += position_ - opener;
             }
             else {
                 break;
@@ -74,150 +129,144 @@ namespace GC {
     }
 
     //------------------------------------------------------------------------------
-    // Tokenize the entire source into a vector of tokens.
+    // Instrumented entry points to skipWhitespaceAndComments() and scanToken(). With
+    // LEXER_STATS undefined they are plain calls.
     //------------------------------------------------------------------------------
-    std::vector<Token> Lexer::tokenize() {
-        std::vector<Token> tokens;
-        while (!isAtEnd()) {
+    void Lexer::skipTriviaCounted() {
+        if constexpr (LexerStatsEnabled) {
+            using Clock = std::chrono::steady_clock;
+            const size_t before = position_;
+            sampling_ = stats_.triviaCalls++ % LexerStats::SampleEvery == 0;
+            const Clock::time_point started = sampling_ ? Clock::now() : Clock::time_point{};
+            skipWhitespaceAndComments();
+            if (sampling_) {
+                stats_.triviaSamples++;
+                stats_.triviaSampleNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - started).count();
+            }
+            stats_.triviaBytes += position_ - before;
+        }
+        else {
             skipWhitespaceAndComments();
-            if (isAtEnd())
-                break;
-            tokens.push_back(scanToken());
         }
-        tokens.push_back(Token(TokenType::EndOfFile, "", location_));
-        return tokens;
     }
 
-    //------------------------------------------------------------------------------
-    // scanToken: Reads the next token from the source.
-    //------------------------------------------------------------------------------
-    Token Lexer::scanToken() {
-        skipWhitespaceAndComments(); // In case theres trailing whitespace
-        TokenLocation tokenStart = location_;
-        char c = advance();
-
-        // Handle single or multi-character tokens.
-        switch (c) {
-        case '+': return Token(TokenType::Plus, "+", tokenStart);
-        case '-':
-            if (!isAtEnd() && peek() == '>') {
-                advance();
-                return Token(TokenType::Arrow, "->", tokenStart);
+    PackedToken Lexer::scanTokenCounted() {
+        if constexpr (LexerStatsEnabled) {
+            using Clock = std::chrono::steady_clock;
+            const Clock::time_point started = sampling_ ? Clock::now() : Clock::time_point{};
+            PackedToken token = scanToken();
+            if (sampling_) {
+                stats_.scanSamples++;
+                stats_.scanSampleNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - started).count();
+                sampling_ = false;
             }
-            return Token(TokenType::Minus, "-", tokenStart);
-        case '*': return Token(TokenType::Multiply, "*", tokenStart);
-        case '/': return Token(TokenType::Divide, "/", tokenStart);
-        case '%': return Token(TokenType::Modulo, "%", tokenStart);
-        case '=':
-            if (!isAtEnd() && peek() == '=') {
-                advance();
-                return Token(TokenType::Equal, "==", tokenStart);
-            }
-            return Token(TokenType::Assign, "=", tokenStart);
-        case '!':
-            if (!isAtEnd() && peek() == '=') {
-                advance();
-                return Token(TokenType::NotEqual, "!=", tokenStart);
-            }
-            return Token(TokenType::Not, "!", tokenStart);
-        case '<': {
-            if (!isAtEnd() && peek() == '=') {
-                advance();
-                return Token(TokenType::LessEqual, "<=", tokenStart);
-            }
-            else if (!isAtEnd() && peek() == '-') {
-                // Possible BiArrow "<->"
-                advance(); // consume '-'
-                if (!isAtEnd() && peek() == '>') {
-                    advance();
-                    return Token(TokenType::BiArrow, "<->", tokenStart);
-                }
-                else {
-                    return Token(TokenType::Less, "<", tokenStart);
-                }
-            }
-            return Token(TokenType::Less, "<", tokenStart);
+            stats_.scanCalls++;
+            stats_.tokens[static_cast<size_t>(token.getType())]++;
+            stats_.tokenBytes += token.getLength();
+            if (TokenTypeCategory(token.getType()) == TokenCategory::Literal)
+                stats_.literalBytes += token.getLength();
+            return token;
         }
-        case '>': {
-            if (!isAtEnd() && peek() == '=') {
-                advance();
-                return Token(TokenType::GreaterEqual, ">=", tokenStart);
-            }
-            return Token(TokenType::Greater, ">", tokenStart);
+        else {
+            return scanToken();
         }
-                // Logical operators starting with '?'
-        case '?': {
-            if (!isAtEnd()) {
-                char next = peek();
-                if (next == '+') {
-                    advance();
-                    return Token(TokenType::And, "?+", tokenStart);
-                }
-                else if (next == '?') {
-                    advance();
-                    return Token(TokenType::Or, "??", tokenStart);
-                }
-            }
-            return Token(TokenType::Unknown, "?", tokenStart);
+    }
+
+    //------------------------------------------------------------------------------
+    // Tokenize the entire source into a token stream.
+    //------------------------------------------------------------------------------
+    TokenStream Lexer::tokenize() {
+        TokenStream tokens(source_);
+        literals_ = &tokens.literalPool();
+        PackedToken token = lexToken();
+        while (token.getType() != TokenType::EndOfFile) {
+            tokens.push(token);
+            token = lexToken();
         }
-        case '&': {
-            // Now, check if this is a reference operator for an immutable reference.
-            if (!isAtEnd() && peek() == '@') {
-                advance(); // consume '@'
-                return Token(TokenType::AmpersandAt, "&@", tokenStart);
+        tokens.push(token);
+        literals_ = nullptr;
+        flushDiagnostics(tokens);
+        return tokens;
+    }
+
+    //------------------------------------------------------------------------------
+    // Tokenize one chunk of the source (see ParallelTokenize.cpp).
+    //------------------------------------------------------------------------------
+    size_t Lexer::tokenizeRange(size_t begin, size_t limit, TokenStream& tokens) {
+        position_ = begin;
+        literals_ = &tokens.literalPool();
+        for (;;) {
+            skipTriviaCounted();
+            if (isAtEnd() || position_ >= limit) {
+                literals_ = nullptr;
+                // Chunks end at a token start, which is never inside a UTF-8 sequence.
+                if (!validated_)
+                    validateUtf8(begin, position_);
+                flushDiagnostics(tokens);
+                return position_;
             }
-            return Token(TokenType::Ampersand, "&", tokenStart);
-        }
-        case '|': {
-            return Token(TokenType::Pipe, "|", tokenStart);
+            tokens.push(scanTokenCounted());
         }
-        case ':': {
-            if (!isAtEnd() && peek() == ':') {
-                advance();
-                return Token(TokenType::DoubleColon, "::", tokenStart);
-            }
-            return Token(TokenType::Colon, ":", tokenStart);
+    }
+
+    //------------------------------------------------------------------------------
+    // Pull interface: hand out buffered tokens first, lexing more only on demand.
+    //------------------------------------------------------------------------------
+    Token Lexer::next() {
+        if (buffered_ == 0)
+            return view(lexToken());
+        PackedToken token = lookahead_[head_];
+        head_ = (head_ + 1) % LookaheadCapacity;
+        buffered_--;
+        return view(token);
+    }
+
+    Token Lexer::peekToken(size_t k) {
+        assert(k < LookaheadCapacity && "peekToken() beyond the lookahead capacity");
+        while (buffered_ <= k) {
+            lookahead_[(head_ + buffered_) % LookaheadCapacity] = lexToken();
+            buffered_++;
         }
-        case '.': {
-            if (!isAtEnd() && peek() == '.') {
+        return view(lookahead_[(head_ + k) % LookaheadCapacity]);
+    }
+
+    //------------------------------------------------------------------------------
+    // lexToken: Skips trivia and scans one token, or returns EndOfFile.
+    //------------------------------------------------------------------------------
+    PackedToken Lexer::lexToken() {
+        if (!validated_)
+            validateUtf8(0, source_.size());
+        skipTriviaCounted();
+        if (isAtEnd())
+            return PackedToken(TokenType::EndOfFile, static_cast<uint32_t>(position_), 0);
+        return scanTokenCounted();
+    }
+
+    //------------------------------------------------------------------------------
+    // scanToken: Reads the next token from the source.
+    //------------------------------------------------------------------------------
+    PackedToken Lexer::scanToken() {
+        skipWhitespaceAndComments(); // In case there's trailing whitespace
+        start_ = position_;
+
+        // Operators and punctuation: longest match through the generated state
+        // machine (see Operators.h). A lone '?' matches nothing and is Unknown.
+        if (IsOperatorStart(peek())) {
+            OperatorMatch match = MatchOperator(source_.data() + position_, source_.data() + source_.size());
+            assert(match.accept != OperatorDfa::LineCommentOpener && match.accept != OperatorDfa::BlockCommentOpener);
+            if (match.accept == OperatorDfa::NoMatch) {
                 advance();
-                return Token(TokenType::Range, "..", tokenStart);
+                return makeToken(TokenType::Unknown);
             }
-            return Token(TokenType::Dot, ".", tokenStart);
-        }
-        case '(': return Token(TokenType::LeftParen, "(", tokenStart);
-        case ')': return Token(TokenType::RightParen, ")", tokenStart);
-        case '{': return Token(TokenType::LeftBrace, "{", tokenStart);
-        case '}': return Token(TokenType::RightBrace, "}", tokenStart);
-        case '[': return Token(TokenType::LeftBracket, "[", tokenStart);
-        case ']': return Token(TokenType::RightBracket, "]", tokenStart);
-        case ',': return Token(TokenType::Comma, ",", tokenStart);
-        case ';': return Token(TokenType::Semicolon, ";", tokenStart);
-        case '@': return Token(TokenType::At, "@", tokenStart);
-        case '#': return Token(TokenType::Hash, "#", tokenStart);
-        default:
-            break;
+            position_ += match.length;
+            return makeToken(static_cast<TokenType>(match.accept));
         }
 
+        char c = advance();
+
         // Number literal: digits (with optional fractional part).
-        if (std::isdigit(c)) {
-            std::string numberStr;
-            numberStr.push_back(c);
-            bool isFloat = false;
-            while (!isAtEnd() && std::isdigit(peek()))
-                numberStr.push_back(advance());
-            if (!isAtEnd() && peek() == '.') {
-                if (peekNext() != '.') {
-                    isFloat = true;
-                    numberStr.push_back(advance()); // consume the dot
-                    while (!isAtEnd() && std::isdigit(peek()))
-                        numberStr.push_back(advance());
-                }
-            }
-            return isFloat
-                ? Token(TokenType::FloatLiteral, numberStr, tokenStart)
-                : Token(TokenType::IntegerLiteral, numberStr, tokenStart);
-        }
+        if (CharClass::Is(c, CharClass::Digit))
+            return number();
 
         // String literal.
         if (c == '"')
@@ -227,104 +276,260 @@ namespace GC {
         if (c == '\'')
             return charLiteral();
 
-        // Identifier or keyword. Allow letters, digits, underscores, and also '@' or '#' in the beginning.
-        if (std::isalpha(c) || c == '_' || c == '@' || c == '#') {
-            std::string ident;
-            ident.push_back(c);
-            while (!isAtEnd() &&
-                (std::isalnum(peek()) || peek() == '_' || peek() == '@' || peek() == '#'))
-            {
-                ident.push_back(advance());
-            }
-            // Check for reserved keywords.
-            if (ident == "import")       return Token(TokenType::Import, ident, tokenStart);
-            if (ident == "iter")         return Token(TokenType::Iter, ident, tokenStart);
-            if (ident == "while")        return Token(TokenType::While, ident, tokenStart);
-            if (ident == "if")           return Token(TokenType::If, ident, tokenStart);
-            if (ident == "else")         return Token(TokenType::Else, ident, tokenStart);
-            if (ident == "enum")         return Token(TokenType::Enum, ident, tokenStart);
-            if (ident == "compare")      return Token(TokenType::Compare, ident, tokenStart);
-            if (ident == "on")           return Token(TokenType::On, ident, tokenStart);
-            if (ident == "default")      return Token(TokenType::Default, ident, tokenStart);
-            if (ident == "public")       return Token(TokenType::Public, ident, tokenStart);
-            if (ident == "private")      return Token(TokenType::Private, ident, tokenStart);
-            if (ident == "continue")     return Token(TokenType::Continue, ident, tokenStart);
-            if (ident == "break")        return Token(TokenType::Break, ident, tokenStart);
-            if (ident == "exitProgram")  return Token(TokenType::ExitProgram, ident, tokenStart);
-            if (ident == "vec")          return Token(TokenType::Vec, ident, tokenStart);
-            if (ident == "tuple")        return Token(TokenType::Tuple, ident, tokenStart);
-            if (ident == "destroy")      return Token(TokenType::Destroy, ident, tokenStart);
-            if (ident == "delete")       return Token(TokenType::Delete, ident, tokenStart);
-            // Type keywords.
-            if (ident == "u8")           return Token(TokenType::U8, ident, tokenStart);
-            if (ident == "u16")          return Token(TokenType::U16, ident, tokenStart);
-            if (ident == "u32")          return Token(TokenType::U32, ident, tokenStart);
-            if (ident == "u64")          return Token(TokenType::U64, ident, tokenStart);
-            if (ident == "i8")           return Token(TokenType::I8, ident, tokenStart);
-            if (ident == "i16")          return Token(TokenType::I16, ident, tokenStart);
-            if (ident == "i32")          return Token(TokenType::I32, ident, tokenStart);
-            if (ident == "i64")          return Token(TokenType::I64, ident, tokenStart);
-            if (ident == "f32")          return Token(TokenType::F32, ident, tokenStart);
-            if (ident == "f64")          return Token(TokenType::F64, ident, tokenStart);
-            if (ident == "bool")         return Token(TokenType::Bool, ident, tokenStart);
-            if (ident == "str")          return Token(TokenType::Str, ident, tokenStart);
-            return Token(TokenType::Identifier, ident, tokenStart);
+        // Identifier or keyword: ASCII letters and '_', or any XID_Start character.
+        if (CharClass::Is(c, CharClass::IdentStart))
+            return identifierOrKeyword();
+        if (CharClass::Is(c, CharClass::NonAscii)) {
+            position_ = start_;
+            char32_t codePoint;
+            int length = CharClass::DecodeUtf8(source_.data() + position_, source_.data() + source_.size(), codePoint);
+            // An unknown character is a single token however many bytes it takes;
+            // a malformed byte (already reported by validation) is one on its own.
+            position_ += length ? length : 1;
+            if (length && CharClass::IsXidStart(codePoint))
+                return identifierOrKeyword();
         }
 
-        // If we havent recognized the character, return an unknown token.
-        return Token(TokenType::Unknown, std::string(1, c), tokenStart);
+        // If we haven't recognized the character, return an unknown token.
+        return makeToken(TokenType::Unknown);
     }
 
     //------------------------------------------------------------------------------
-    // stringLiteral: Reads a string literal (allowing for simple escape sequences).
+    // Digit separators: "1_000_000" is parsed as "1000000".
     //------------------------------------------------------------------------------
-    Token Lexer::stringLiteral() {
-        TokenLocation tokenStart = location_;
-        std::string str;
-        while (!isAtEnd() && peek() != '"') {
-            if (peek() == '\\') {
-                advance(); // skip the backslash
-                if (!isAtEnd()) {
-                    char escaped = advance();
-                    str.push_back(escaped);
-                }
+    static std::string_view StripSeparators(std::string_view text, std::string& storage) {
+        if (text.find('_') == std::string_view::npos)
+            return text;
+        storage.reserve(text.size());
+        for (char c : text) {
+            if (c != '_')
+                storage.push_back(c);
+        }
+        return storage;
+    }
+
+    //------------------------------------------------------------------------------
+    // number: Reads an integer or float literal; the first digit is already consumed.
+    // The value is parsed here once, so later stages never re-read the lexeme.
+    //------------------------------------------------------------------------------
+    PackedToken Lexer::number() {
+        if (source_[start_] == '0' && (peek() == 'x' || peek() == 'X')) {
+            advance();
+            return prefixedNumber(16);
+        }
+        if (source_[start_] == '0' && (peek() == 'b' || peek() == 'B')) {
+            advance();
+            return prefixedNumber(2);
+        }
+
+        bool isFloat = false;
+        while (!isAtEnd() && (CharClass::Is(peek(), CharClass::Digit) || peek() == '_'))
+            advance();
+        if (!isAtEnd() && peek() == '.') {
+            if (peekNext() != '.') {
+                isFloat = true;
+                advance(); // consume the dot
+                while (!isAtEnd() && (CharClass::Is(peek(), CharClass::Digit) || peek() == '_'))
+                    advance();
             }
-            else {
-                str.push_back(advance());
+        }
+
+        std::string_view text = source_.substr(start_, position_ - start_);
+        std::string storage;
+        std::string_view digits = StripSeparators(text, storage);
+
+        if (isFloat) {
+            double value = 0.0;
+            if (std::from_chars(digits.data(), digits.data() + digits.size(), value).ec == std::errc::result_out_of_range)
+                report(start_, "float literal '" + std::string(text) + "' is out of range");
+            return makeToken(TokenType::FloatLiteral, value);
+        }
+
+        uint64_t value = 0;
+        if (std::from_chars(digits.data(), digits.data() + digits.size(), value).ec == std::errc::result_out_of_range)
+            report(start_, "integer literal '" + std::string(text) + "' does not fit in 64 bits");
+        return makeToken(TokenType::IntegerLiteral, value);
+    }
+
+    //------------------------------------------------------------------------------
+    // prefixedNumber: Reads the digits of a 0x (hex) or 0b (binary) literal.
+    //------------------------------------------------------------------------------
+    PackedToken Lexer::prefixedNumber(int base) {
+        // Take every alphanumeric so that a stray digit is reported, not split off.
+        while (!isAtEnd() && (CharClass::Is(peek(), CharClass::Digit | CharClass::IdentStart)))
+            advance();
+
+        std::string_view text = source_.substr(start_, position_ - start_);
+        std::string storage;
+        std::string_view digits = StripSeparators(text.substr(2), storage);
+        const char* kind = base == 16 ? "hex" : "binary";
+
+        uint64_t value = 0;
+        if (digits.empty()) {
+            report(start_, std::string(kind) + " literal '" + std::string(text) + "' has no digits");
+            return makeToken(TokenType::IntegerLiteral, value);
+        }
+        auto [end, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), value, base);
+        if (end != digits.data() + digits.size())
+            report(start_, "invalid digit '" + std::string(1, *end) + "' in " + kind + " literal '" + std::string(text) + "'");
+        else if (ec == std::errc::result_out_of_range)
+            report(start_, "integer literal '" + std::string(text) + "' does not fit in 64 bits");
+        return makeToken(TokenType::IntegerLiteral, value);
+    }
+
+    //------------------------------------------------------------------------------
+    // identifierOrKeyword: Reads an identifier; the first character is already consumed.
+    // ASCII bytes take the class table fast path; other code points are decoded
+    // and must be XID_Continue (UAX #31).
+    //------------------------------------------------------------------------------
+    PackedToken Lexer::identifierOrKeyword() {
+        const char* end = source_.data() + source_.size();
+        while (!isAtEnd()) {
+            char c = peek();
+            if (CharClass::Is(c, CharClass::IdentContinue)) {
+                advance();
+                continue;
             }
+            // Non-ASCII: continue while the next code point is XID_Continue.
+            char32_t codePoint;
+            int length = CharClass::Is(c, CharClass::NonAscii)
+                ? CharClass::DecodeUtf8(source_.data() + position_, end, codePoint) : 0;
+            if (length == 0 || !CharClass::IsXidContinue(codePoint))
+                break;
+            position_ += length;
         }
-        if (!isAtEnd())
-            advance(); // consume closing quote
-        return Token(TokenType::StringLiteral, str, tokenStart);
+        std::string_view ident = source_.substr(start_, position_ - start_);
+
+        // Reserved keywords resolve through a compile-time perfect hash; every other
+        // name is interned so later stages compare identifiers by SymbolId.
+        TokenType type = LookupKeyword(ident);
+        if (type != TokenType::Identifier)
+            return makeToken(type);
+        return PackedToken(type, static_cast<uint32_t>(start_), static_cast<uint32_t>(ident.size()),
+            PackedToken::HasSymbol, symbols_->intern(ident));
     }
 
     //------------------------------------------------------------------------------
-    // charLiteral: Reads a character literal (allowing for simple escape sequences).
+    // Escape sequences: \n \t \r \\ \" \' \0 and \xHH. The table maps the byte after
+    // the backslash to the decoded byte, or -1 when that escape is unknown.
+    //------------------------------------------------------------------------------
+    namespace {
+
+        constexpr std::array<int16_t, 256> EscapeTable = [] {
+            std::array<int16_t, 256> table{};
+            table.fill(-1);
+            table['n'] = '\n';
+            table['t'] = '\t';
+            table['r'] = '\r';
+            table['\\'] = '\\';
+            table['"'] = '"';
+            table['\''] = '\'';
+            table['0'] = '\0';
+            return table;
+        }();
+
+        // Hex digit value, or -1.
+        constexpr std::array<int8_t, 256> HexDigits = [] {
+            std::array<int8_t, 256> digits{};
+            digits.fill(-1);
+            for (int i = 0; i < 10; i++)
+                digits['0' + i] = static_cast<int8_t>(i);
+            for (int i = 0; i < 6; i++) {
+                digits['a' + i] = static_cast<int8_t>(10 + i);
+                digits['A' + i] = static_cast<int8_t>(10 + i);
+            }
+            return digits;
+        }();
+
+    } // namespace
+
+    //------------------------------------------------------------------------------
+    // decodeEscape: Decodes the escape sequence at the current backslash.
     //------------------------------------------------------------------------------
-    Token Lexer::charLiteral() {
-        TokenLocation tokenStart = location_;
-        std::string str;
-        while (!isAtEnd() && peek() != '\'') {
-            if (peek() == '\\') {
+    void Lexer::decodeEscape() {
+        size_t backslash = position_;
+        advance(); // '\'
+        if (isAtEnd())
+            return;
+        unsigned char escaped = static_cast<unsigned char>(advance());
+
+        if (escaped == 'x') {
+            int value = 0;
+            int count = 0;
+            for (; count < 2 && !isAtEnd(); count++) {
+                int digit = HexDigits[static_cast<unsigned char>(peek())];
+                if (digit < 0)
+                    break;
+                value = value * 16 + digit;
                 advance();
-                if (!isAtEnd()) {
-                    char escaped = advance();
-                    str.push_back(escaped);
-                }
             }
-            else {
-                str.push_back(advance());
+            if (count == 0)
+                report(backslash, "\\x escape without hex digits");
+            quoted_.push_back(static_cast<char>(value));
+            return;
+        }
+
+        int16_t decoded = EscapeTable[escaped];
+        if (decoded < 0) {
+            report(backslash, "unknown escape sequence '\\" + std::string(1, static_cast<char>(escaped)) + "'");
+            decoded = escaped;
+        }
+        quoted_.push_back(static_cast<char>(decoded));
+    }
+
+    //------------------------------------------------------------------------------
+    // scanQuoted: Decodes the body of a quoted literal into quoted_ and consumes the
+    // closing quote. Runs between escapes are found with a SIMD scan and copied in
+    // one append. Returns false when the source ends first.
+    //------------------------------------------------------------------------------
+    bool Lexer::scanQuoted(char quote) {
+        quoted_.clear();
+        const char* base = source_.data();
+        const char* end = base + source_.size();
+        for (;;) {
+            const char* run = base + position_;
+            const char* stop = Simd::FindEitherByte(run, end, quote, '\\');
+            quoted_.append(run, stop);
+            position_ = static_cast<size_t>(stop - base);
+            if (stop == end)
+                return false;
+            if (*stop == quote) {
+                advance();
+                return true;
             }
+            decodeEscape();
         }
-        if (!isAtEnd())
-            advance(); // consume closing quote
-        return Token(TokenType::CharLiteral, str, tokenStart);
     }
 
     //------------------------------------------------------------------------------
-    // Convenience function.
+    // stringLiteral: Reads a string literal; the opening quote is already consumed.
     //------------------------------------------------------------------------------
-    std::vector<Token> Tokenize(const std::string& source) {
+    PackedToken Lexer::stringLiteral() {
+        if (!scanQuoted('"'))
+            report(start_, "unterminated string literal");
+        // The lexeme keeps the raw quoted text; the decoded value is the literal.
+        return makeToken(TokenType::StringLiteral, context_.storeLiteral(quoted_));
+    }
+
+    //------------------------------------------------------------------------------
+    // charLiteral: Reads a character literal; the opening quote is already consumed.
+    //------------------------------------------------------------------------------
+    PackedToken Lexer::charLiteral() {
+        if (!scanQuoted('\''))
+            report(start_, "unterminated character literal");
+        if (quoted_.size() == 1)
+            return makeToken(TokenType::CharLiteral, quoted_.front());
+        return makeToken(TokenType::CharLiteral, context_.storeLiteral(quoted_));
+    }
+
+    //------------------------------------------------------------------------------
+    // Convenience functions.
+    //------------------------------------------------------------------------------
+    TokenStream Tokenize(const CompilationUnit& unit) {
+        return Tokenize(unit.getSource());
+    }
+
+    TokenStream Tokenize(std::string_view source) {
         Lexer lexer(source);
         return lexer.tokenize();
     }
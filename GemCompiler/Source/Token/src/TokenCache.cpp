@@ -0,0 +1,364 @@
+#include "../TokenCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#include "../../Unit/Hash.h"
+#include "../../Unit/SourceFile.h"
+#include "../../Version.h"
+
+namespace GC {
+
+    namespace {
+
+        //------------------------------------------------------------------------------
+        // 1. File Format
+        //
+        // A fixed header, then the body: literal records, the offset, length and
+        // payload arrays, symbol names, diagnostics, the kind array, and last the
+        // bytes of every string the records refer to. Payloads index the entry's own
+        // symbol and literal tables. Integers are in host byte order (the header
+        // carries a mark to check it); a cache directory is not meant to move
+        // between machines.
+        //------------------------------------------------------------------------------
+        constexpr char Magic[8] = { 'G', 'E', 'M', 'T', 'O', 'K', 'S', '\0' };
+        constexpr uint32_t FormatVersion = 1;
+        constexpr uint32_t EndianMark = 0x01020304;
+
+        struct Header {
+            char magic[8];
+            uint32_t format;
+            uint32_t endianMark;
+            uint64_t key;               // Hash of the source, seeded by VersionSeed().
+            uint64_t sourceSize;
+            uint64_t bodySize;
+            uint64_t bodyHash;
+            uint32_t tokenCount;
+            uint32_t symbolCount;
+            uint32_t literalCount;
+            uint32_t diagnosticCount;
+            uint32_t stringBytes;
+            uint32_t reserved;
+        };
+
+        struct StringRef {
+            uint32_t offset;            // Into the string bytes.
+            uint32_t length;
+        };
+
+        struct LiteralRecord {
+            uint32_t tag;               // TokenLiteral::index().
+            uint32_t length;            // Strings: byte count.
+            uint64_t value;             // Numbers and chars: the bits. Strings: offset.
+        };
+
+        struct DiagnosticRecord {
+            uint32_t severity;
+            uint32_t offset;
+            StringRef message;
+        };
+
+        struct Layout {
+            size_t literals, offsets, lengths, payloads, symbols, diagnostics, kinds, strings, end;
+        };
+
+        Layout ComputeLayout(const Header& header) {
+            const size_t tokens = header.tokenCount;
+            Layout layout{};
+            size_t at = 0;
+            layout.literals = at;       at += size_t{ header.literalCount } * sizeof(LiteralRecord);
+            layout.offsets = at;        at += tokens * sizeof(uint32_t);
+            layout.lengths = at;        at += tokens * sizeof(uint32_t);
+            layout.payloads = at;       at += tokens * sizeof(uint32_t);
+            layout.symbols = at;        at += size_t{ header.symbolCount } * sizeof(StringRef);
+            layout.diagnostics = at;    at += size_t{ header.diagnosticCount } * sizeof(DiagnosticRecord);
+            layout.kinds = at;          at += tokens;
+            layout.strings = at;        at += header.stringBytes;
+            layout.end = at;
+            return layout;
+        }
+
+        // Entries are keyed on the compiler version and the format, on the token
+        // and literal layouts, and on every token spelling in enum order, so a new
+        // compiler, a changed token table or a repacked token misses. What the
+        // lexer makes of the same bytes is not covered: a change to its scanning,
+        // literal decoding or diagnostics must bump CompilerVersion (Version.h).
+        uint64_t VersionSeed() {
+            static const uint64_t seed = [] {
+                uint64_t hash = Hash64(CompilerVersion, FormatVersion);
+                const uint64_t layouts[] = { sizeof(PackedToken), sizeof(LiteralRecord),
+                    std::variant_size_v<TokenLiteral>, TokenTypeCount };
+                hash = Hash64(layouts, sizeof(layouts), hash);
+                for (const TokenSpelling& spelling : TokenSpellings)
+                    hash = Hash64(spelling.text, hash ^ static_cast<uint64_t>(spelling.category));
+                return hash;
+            }();
+            return seed;
+        }
+
+        std::string EntryPath(const std::string& directory, uint64_t key) {
+            char name[32];
+            std::snprintf(name, sizeof(name), "%016llx.gtok", static_cast<unsigned long long>(key));
+            return (std::filesystem::path(directory) / name).string();
+        }
+
+        //------------------------------------------------------------------------------
+        // 2. Literals
+        //------------------------------------------------------------------------------
+        template<typename AddString>
+        LiteralRecord EncodeLiteral(const TokenLiteral& literal, AddString&& addString) {
+            LiteralRecord record{ static_cast<uint32_t>(literal.index()), 0, 0 };
+            if (auto text = std::get_if<std::string_view>(&literal)) {
+                StringRef ref = addString(*text);
+                record.length = ref.length;
+                record.value = ref.offset;
+            }
+            else if (auto value = std::get_if<uint64_t>(&literal)) {
+                record.value = *value;
+            }
+            else if (auto value = std::get_if<int64_t>(&literal)) {
+                std::memcpy(&record.value, value, sizeof(*value));
+            }
+            else if (auto value = std::get_if<double>(&literal)) {
+                std::memcpy(&record.value, value, sizeof(*value));
+            }
+            else if (auto value = std::get_if<char>(&literal)) {
+                record.value = static_cast<unsigned char>(*value);
+            }
+            return record;
+        }
+
+        TokenLiteral DecodeLiteral(const LiteralRecord& record, std::string_view strings, CompilationContext& context) {
+            switch (record.tag) {
+            case 1:
+                return record.value;
+            case 2: {
+                int64_t value;
+                std::memcpy(&value, &record.value, sizeof(value));
+                return value;
+            }
+            case 3: {
+                double value;
+                std::memcpy(&value, &record.value, sizeof(value));
+                return value;
+            }
+            case 4:
+                return static_cast<char>(record.value);
+            case 5:
+                return context.storeLiteral(strings.substr(record.value, record.length));
+            default:
+                return std::monostate{};
+            }
+        }
+        static_assert(std::variant_size_v<TokenLiteral> == 6, "Update the literal encoding");
+
+        //------------------------------------------------------------------------------
+        // 3. Reading: copies a record array out of the mapped body.
+        //------------------------------------------------------------------------------
+        template<typename T>
+        std::vector<T> ReadArray(std::string_view body, size_t at, size_t count) {
+            std::vector<T> values(count);
+            if (count)
+                std::memcpy(values.data(), body.data() + at, count * sizeof(T));
+            return values;
+        }
+
+        bool ValidRef(const StringRef& ref, uint32_t stringBytes) {
+            return uint64_t{ ref.offset } + ref.length <= stringBytes;
+        }
+
+    } // namespace
+
+    std::string TokenCache::entryPath(std::string_view source) const {
+        return EntryPath(directory_, Hash64(source, VersionSeed()));
+    }
+
+    //------------------------------------------------------------------------------
+    // 4. Loading. Every count, range and index is checked before anything is
+    // interned or added to `tokens`, so a bad entry has no effect but a miss.
+    //------------------------------------------------------------------------------
+    bool TokenCache::load(std::string_view source, TokenStream& tokens, CompilationContext& context) const {
+        if (!enabled())
+            return false;
+        const uint64_t key = Hash64(source, VersionSeed());
+        SourceFile file;
+        std::string error;
+        if (!SourceFile::Open(EntryPath(directory_, key), file, error))
+            return false;
+
+        std::string_view image = file.getText();
+        Header header;
+        if (image.size() < sizeof(header))
+            return false;
+        std::memcpy(&header, image.data(), sizeof(header));
+        // The entry is matched on its 64-bit key and the source size only; the
+        // source bytes are not stored, so two sources of one size with the same
+        // key are assumed not to occur.
+        if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.format != FormatVersion
+            || header.endianMark != EndianMark || header.key != key || header.sourceSize != source.size())
+            return false;
+
+        // Truncated or corrupt.
+        std::string_view body = image.substr(sizeof(header));
+        const Layout layout = ComputeLayout(header);
+        if (header.tokenCount == 0 || header.bodySize != body.size() || layout.end != body.size()
+            || Hash64(body) != header.bodyHash)
+            return false;
+
+        const size_t count = header.tokenCount;
+        const std::string_view strings = body.substr(layout.strings, header.stringBytes);
+        const auto literals = ReadArray<LiteralRecord>(body, layout.literals, header.literalCount);
+        auto offsets = ReadArray<uint32_t>(body, layout.offsets, count);
+        auto lengths = ReadArray<uint32_t>(body, layout.lengths, count);
+        auto payloads = ReadArray<uint32_t>(body, layout.payloads, count);
+        const auto symbols = ReadArray<StringRef>(body, layout.symbols, header.symbolCount);
+        const auto diagnostics = ReadArray<DiagnosticRecord>(body, layout.diagnostics, header.diagnosticCount);
+        auto kinds = ReadArray<TokenType>(body, layout.kinds, count);
+
+        for (const LiteralRecord& literal : literals) {
+            if (literal.tag >= std::variant_size_v<TokenLiteral>)
+                return false;
+            if (literal.tag == 5 && !ValidRef(StringRef{ static_cast<uint32_t>(literal.value), literal.length }, header.stringBytes))
+                return false;
+        }
+        for (const StringRef& symbol : symbols) {
+            if (!ValidRef(symbol, header.stringBytes))
+                return false;
+        }
+        for (const DiagnosticRecord& diagnostic : diagnostics) {
+            if (diagnostic.severity > static_cast<uint32_t>(Diagnostic::Severity::Error)
+                || diagnostic.offset > source.size() || !ValidRef(diagnostic.message, header.stringBytes))
+                return false;
+        }
+        for (size_t i = 0; i < count; i++) {
+            if (static_cast<size_t>(kinds[i]) >= TokenTypeCount || uint64_t{ offsets[i] } + lengths[i] > source.size()
+                || (i > 0 && offsets[i] < offsets[i - 1]))
+                return false;
+            const uint32_t limit = kinds[i] == TokenType::Identifier ? header.symbolCount : header.literalCount;
+            if (payloads[i] != TokenStream::NoPayload && payloads[i] >= limit)
+                return false;
+        }
+        if (kinds[count - 1] != TokenType::EndOfFile)
+            return false;
+
+        // The entry is sound: rebuild the stream against this process's context.
+        std::vector<SymbolId> symbolIds;
+        symbolIds.reserve(symbols.size());
+        for (const StringRef& symbol : symbols)
+            symbolIds.push_back(context.interner().intern(strings.substr(symbol.offset, symbol.length)));
+
+        TokenStream result(source);
+        for (size_t i = 0; i < count; i++) {
+            uint32_t& payload = payloads[i];
+            if (payload != TokenStream::NoPayload) {
+                payload = kinds[i] == TokenType::Identifier ? symbolIds[payload]
+                    : result.literalPool().add(DecodeLiteral(literals[payload], strings, context));
+            }
+        }
+        result.assign(std::move(kinds), std::move(offsets), std::move(lengths), std::move(payloads));
+        for (const DiagnosticRecord& diagnostic : diagnostics) {
+            result.addDiagnostic(Diagnostic{ static_cast<Diagnostic::Severity>(diagnostic.severity), diagnostic.offset,
+                context.storeMessage(strings.substr(diagnostic.message.offset, diagnostic.message.length)) });
+        }
+        tokens = std::move(result);
+        return true;
+    }
+
+    //------------------------------------------------------------------------------
+    // 5. Storing. The entry is written to a temporary file and renamed into place,
+    // so concurrent compilers never see a half-written entry under the final name.
+    //------------------------------------------------------------------------------
+    bool TokenCache::store(std::string_view source, const TokenStream& tokens, CompilationContext& context) const {
+        if (!enabled() || tokens.empty() || source.size() > UINT32_MAX)
+            return false;
+
+        const size_t count = tokens.size();
+        std::vector<LiteralRecord> literals;
+        std::vector<uint32_t> payloads(count, TokenStream::NoPayload);
+        std::vector<StringRef> symbols;
+        std::unordered_map<SymbolId, uint32_t> localSymbols;
+        std::string strings;
+        const auto addString = [&](std::string_view text) {
+            StringRef ref{ static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(text.size()) };
+            strings.append(text);
+            return ref;
+        };
+
+        for (size_t i = 0; i < count; i++) {
+            if (tokens.kind(i) == TokenType::Identifier) {
+                auto [slot, added] = localSymbols.try_emplace(tokens.symbol(i), static_cast<uint32_t>(symbols.size()));
+                if (added)
+                    symbols.push_back(addString(context.interner().name(tokens.symbol(i))));
+                payloads[i] = slot->second;
+            }
+            else if (tokens.hasLiteral(i)) {
+                payloads[i] = static_cast<uint32_t>(literals.size());
+                literals.push_back(EncodeLiteral(tokens.literal(i), addString));
+            }
+        }
+        std::vector<DiagnosticRecord> diagnostics;
+        for (const Diagnostic& diagnostic : tokens.diagnostics()) {
+            diagnostics.push_back(DiagnosticRecord{ static_cast<uint32_t>(diagnostic.severity), diagnostic.offset,
+                addString(diagnostic.message) });
+        }
+        if (strings.size() > UINT32_MAX)
+            return false;
+
+        Header header{};
+        std::memcpy(header.magic, Magic, sizeof(Magic));
+        header.format = FormatVersion;
+        header.endianMark = EndianMark;
+        header.key = Hash64(source, VersionSeed());
+        header.sourceSize = source.size();
+        header.tokenCount = static_cast<uint32_t>(count);
+        header.symbolCount = static_cast<uint32_t>(symbols.size());
+        header.literalCount = static_cast<uint32_t>(literals.size());
+        header.diagnosticCount = static_cast<uint32_t>(diagnostics.size());
+        header.stringBytes = static_cast<uint32_t>(strings.size());
+        const Layout layout = ComputeLayout(header);
+        header.bodySize = layout.end;
+
+        std::vector<char> image(sizeof(header) + layout.end);
+        char* body = image.data() + sizeof(header);
+        const auto put = [&](size_t at, const void* data, size_t size) {
+            if (size)
+                std::memcpy(body + at, data, size);
+        };
+        put(layout.literals, literals.data(), literals.size() * sizeof(LiteralRecord));
+        put(layout.offsets, tokens.offsets().data(), count * sizeof(uint32_t));
+        for (size_t i = 0; i < count; i++) {
+            uint32_t length = tokens.length(i);
+            put(layout.lengths + i * sizeof(uint32_t), &length, sizeof(length));
+        }
+        put(layout.payloads, payloads.data(), count * sizeof(uint32_t));
+        put(layout.symbols, symbols.data(), symbols.size() * sizeof(StringRef));
+        put(layout.diagnostics, diagnostics.data(), diagnostics.size() * sizeof(DiagnosticRecord));
+        put(layout.kinds, tokens.kinds().data(), count);
+        put(layout.strings, strings.data(), strings.size());
+        header.bodyHash = Hash64(body, layout.end);
+        std::memcpy(image.data(), &header, sizeof(header));
+
+        std::error_code ec;
+        std::filesystem::create_directories(directory_, ec);
+        const std::string path = EntryPath(directory_, header.key);
+        const std::string temporary = path + "." + std::to_string(std::random_device{}()) + ".tmp";
+        std::FILE* stream = std::fopen(temporary.c_str(), "wb");
+        if (!stream)
+            return false;
+        bool written = std::fwrite(image.data(), 1, image.size(), stream) == image.size();
+        written = std::fclose(stream) == 0 && written;
+        if (written)
+            std::filesystem::rename(temporary, path, ec);
+        if (!written || ec) {
+            std::filesystem::remove(temporary, ec);
+            return false;
+        }
+        return true;
+    }
+
+} // namespace GC
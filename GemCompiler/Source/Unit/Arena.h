@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace GC {
+
+    //------------------------------------------------------------------------------
+    // Arena Statistics
+    //
+    // Arenas never give memory back before they are destroyed, so `used` is also
+    // the high-water mark.
+    //------------------------------------------------------------------------------
+    struct ArenaStats {
+        size_t used{ 0 };           // Bytes handed out, alignment padding included.
+        size_t reserved{ 0 };       // Bytes held in blocks.
+        size_t blocks{ 0 };
+    };
+
+    //------------------------------------------------------------------------------
+    // Arena
+    //
+    // A bump allocator for data that lives as long as the compilation: allocation
+    // is a pointer increment, and everything is released at once when the arena is
+    // destroyed, so objects placed here must be trivially destructible. Blocks
+    // double in size up to MaxBlockSize; an allocation larger than a quarter of a
+    // block gets a block of its own. Not thread-safe; CompilationContext and
+    // Interner lock around their arenas.
+    //------------------------------------------------------------------------------
+    class Arena {
+    public:
+        static constexpr size_t InitialBlockSize = 64 * 1024;
+        static constexpr size_t MaxBlockSize = 4 * 1024 * 1024;
+
+        Arena() = default;
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+        Arena(Arena&&) noexcept = default;
+        Arena& operator=(Arena&&) noexcept = default;
+
+        void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+            uintptr_t cursor = reinterpret_cast<uintptr_t>(cursor_);
+            uintptr_t aligned = (cursor + alignment - 1) & ~(uintptr_t(alignment) - 1);
+            if (cursor_ && aligned + size <= reinterpret_cast<uintptr_t>(limit_)) {
+                used_ += aligned + size - cursor;
+                cursor_ = reinterpret_cast<char*>(aligned + size);
+                return reinterpret_cast<void*>(aligned);
+            }
+            return allocateSlow(size, alignment);
+        }
+
+        // Copies `text` into the arena; the view stays valid for the arena's life.
+        std::string_view copy(std::string_view text) {
+            if (text.empty())
+                return {};
+            char* dest = static_cast<char*>(allocate(text.size(), 1));
+            std::memcpy(dest, text.data(), text.size());
+            return std::string_view(dest, text.size());
+        }
+
+        template<typename T, typename... Args>
+        T* create(Args&&... args) {
+            static_assert(std::is_trivially_destructible_v<T>, "Arena objects are never destroyed");
+            return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        }
+
+        ArenaStats stats() const noexcept { return ArenaStats{ used_, reserved_, blocks_.size() }; }
+
+    private:
+        void* allocateSlow(size_t size, size_t alignment);
+
+        std::vector<std::unique_ptr<char[]>> blocks_;
+        char* cursor_{ nullptr };
+        char* limit_{ nullptr };
+        size_t nextBlockSize_{ InitialBlockSize };
+        size_t used_{ 0 };
+        size_t reserved_{ 0 };
+    };
+
+} // namespace GC
@@ -0,0 +1,52 @@
+#pragma once
+#include <mutex>
+#include <string_view>
+
+#include "Arena.h"
+#include "../Token/Interner.h"
+#include "../Token/LexerStats.h"
+
+namespace GC {
+
+    //------------------------------------------------------------------------------
+    // Compilation Context
+    //
+    // Owns everything that lives as long as the compilation rather than one token
+    // stream: decoded literal text, interned identifiers and diagnostic messages,
+    // each in its own arena, and the lexer counters of every lexer that used it.
+    // Token literals and diagnostics only hold views into these arenas, so the
+    // context is pinned and has to outlive them; tearing it down frees a handful
+    // of blocks instead of one string per literal. All members are safe to call
+    // from parallel lexers.
+    //------------------------------------------------------------------------------
+    class CompilationContext {
+    public:
+        CompilationContext() = default;
+        CompilationContext(const CompilationContext&) = delete;
+        CompilationContext& operator=(const CompilationContext&) = delete;
+
+        // The process-wide context: the default for lexers that are not given one.
+        static CompilationContext& Global();
+
+        std::string_view storeLiteral(std::string_view text);
+        std::string_view storeMessage(std::string_view text);
+        Interner& interner() noexcept { return interner_; }
+
+        // High-water marks, for --stats.
+        ArenaStats literalStats() const;
+        ArenaStats messageStats() const;
+        ArenaStats symbolStats() const { return interner_.arenaStats(); }
+
+        // Lexers add their counters when they are destroyed (see LexerStats.h).
+        void addLexerStats(const LexerStats& stats);
+        LexerStats lexerStats() const;
+
+    private:
+        mutable std::mutex mutex_;
+        Arena literals_;
+        Arena messages_;
+        Interner interner_;
+        LexerStats lexerStats_;
+    };
+
+} // namespace GC
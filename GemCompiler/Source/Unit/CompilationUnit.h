@@ -0,0 +1,44 @@
+#pragma once
+#include <string>
+#include <string_view>
+
+#include "SourceFile.h"
+#include "SourceMap.h"
+
+namespace GC {
+
+    //------------------------------------------------------------------------------
+    // Compilation Unit
+    //
+    // Owns the source bytes of one input file (usually a read-only mapping of it).
+    // Tokens only hold views into these bytes, so the unit is pinned (neither
+    // copyable nor movable) and has to outlive every token vector built from it.
+    //------------------------------------------------------------------------------
+    class CompilationUnit {
+    public:
+        CompilationUnit(std::string path, SourceFile file)
+            : path_(std::move(path))
+            , file_(std::move(file))
+            , sourceMap_(file_.getText()) {}
+
+        CompilationUnit(std::string path, std::string_view source)
+            : CompilationUnit(std::move(path), SourceFile::FromString(source)) {}
+
+        CompilationUnit(const CompilationUnit&) = delete;
+        CompilationUnit(CompilationUnit&&) = delete;
+        CompilationUnit& operator=(const CompilationUnit&) = delete;
+        CompilationUnit& operator=(CompilationUnit&&) = delete;
+        ~CompilationUnit() = default;
+
+        // Accessors.
+        const std::string& getPath() const noexcept { return path_; }
+        std::string_view getSource() const noexcept { return file_.getText(); }
+        const SourceMap& getSourceMap() const noexcept { return sourceMap_; }
+
+    private:
+        std::string path_;
+        SourceFile file_;
+        SourceMap sourceMap_;
+    };
+
+} // namespace GC
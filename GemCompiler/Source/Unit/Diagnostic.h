@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "CompilationUnit.h"
+
+namespace GC {
+
+    //------------------------------------------------------------------------------
+    // Diagnostic
+    //
+    // A message anchored at a byte offset of a compilation unit's source. The
+    // offset is only turned into line:column when the diagnostic is printed. The
+    // message text lives in the CompilationContext's arena.
+    //------------------------------------------------------------------------------
+    struct Diagnostic {
+        enum class Severity {
+            Warning,
+            Error
+        };
+
+        Severity severity;
+        uint32_t offset;
+        std::string_view message;
+    };
+
+    inline std::string FormatDiagnostic(const CompilationUnit& unit, const Diagnostic& diagnostic) {
+        std::ostringstream oss;
+        oss << unit.getPath() << ":" << unit.getSourceMap().locate(diagnostic.offset) << ": "
+            << (diagnostic.severity == Diagnostic::Severity::Error ? "error" : "warning") << ": "
+            << diagnostic.message;
+        return oss.str();
+    }
+
+} // namespace GC
@@ -0,0 +1,21 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace GC {
+
+    //------------------------------------------------------------------------------
+    // Content Hashing
+    //
+    // A fast 64-bit non-cryptographic hash (the wyhash construction: 48 bytes per
+    // step through three independent 64x64->128 multiply-folds), for keying caches
+    // on file contents. Good enough to tell files apart, not to resist an attacker.
+    //------------------------------------------------------------------------------
+    uint64_t Hash64(const void* data, size_t size, uint64_t seed = 0) noexcept;
+
+    inline uint64_t Hash64(std::string_view text, uint64_t seed = 0) noexcept {
+        return Hash64(text.data(), text.size(), seed);
+    }
+
+} // namespace GC
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace GC {
+
+    //------------------------------------------------------------------------------
+    // Source File
+    //
+    // Read-only bytes of one input. Regular files are memory-mapped, so loading a
+    // file costs no copy and pages are only faulted in as the lexer reaches them.
+    // Pipes, stdin ("-") and anything else that cannot be mapped are read into an
+    // owned buffer instead. Either way the bytes keep their address when the
+    // SourceFile is moved, so views taken from getText() stay valid.
+    //------------------------------------------------------------------------------
+    class SourceFile {
+    public:
+        SourceFile() = default;
+        SourceFile(const SourceFile&) = delete;
+        SourceFile& operator=(const SourceFile&) = delete;
+        SourceFile(SourceFile&& other) noexcept;
+        SourceFile& operator=(SourceFile&& other) noexcept;
+        ~SourceFile();
+
+        // Opens `path` ("-" is stdin). On failure returns false and fills `error`.
+        static bool Open(const std::string& path, SourceFile& out, std::string& error);
+
+        // Wraps in-memory text (benchmarks, tests, generated code).
+        static SourceFile FromString(std::string_view text);
+
+        std::string_view getText() const noexcept { return { data_, size_ }; }
+        size_t size() const noexcept { return size_; }
+        bool isMapped() const noexcept { return mapping_ != nullptr; }
+
+    private:
+        void release() noexcept;
+
+        const char* data_{ nullptr };
+        size_t size_{ 0 };
+        void* mapping_{ nullptr };      // Base of the mapped view, when mapped.
+        std::vector<char> buffer_;      // Owned bytes, when not mapped.
+    };
+
+} // namespace GC
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace GC {
+
+    //------------------------------------------------------------------------------
+    // 1. Source Location
+    //
+    // Tokens only record the byte offset of their lexeme. The compilation unit's
+    // SourceMap turns an offset into a TokenLocation when a diagnostic needs one.
+    //------------------------------------------------------------------------------
+    struct TokenLocation {
+        int line{ 1 };
+        int column{ 1 };
+
+        friend std::ostream& operator<<(std::ostream& os, const TokenLocation& loc) {
+            os << loc.line << ":" << loc.column;
+            return os;
+        }
+    };
+
+    //------------------------------------------------------------------------------
+    // 2. Source Map
+    //
+    // Maps byte offsets to line:column. Tokens only store offsets, so the table of
+    // line starts is built on the first lookup (normally when printing the first
+    // diagnostic) and each lookup is a binary search over it.
+    //------------------------------------------------------------------------------
+    class SourceMap {
+    public:
+        explicit SourceMap(std::string_view source)
+            : source_(source) {}
+
+        SourceMap(const SourceMap&) = delete;
+        SourceMap& operator=(const SourceMap&) = delete;
+
+        TokenLocation locate(uint32_t offset) const;
+        size_t lineCount() const;
+
+    private:
+        const std::vector<uint32_t>& lineStarts() const;
+
+        std::string_view source_;
+        mutable std::once_flag built_;
+        mutable std::vector<uint32_t> lineStarts_;
+    };
+
+} // namespace GC
@@ -0,0 +1,29 @@
+#include "../Arena.h"
+
+#include <algorithm>
+
+namespace GC {
+
+    //------------------------------------------------------------------------------
+    // Out of room in the current block. Oversized requests get a dedicated block
+    // and leave the current one open for the small allocations that follow.
+    //------------------------------------------------------------------------------
+    void* Arena::allocateSlow(size_t size, size_t alignment) {
+        const size_t needed = size + alignment - 1;
+        if (needed > nextBlockSize_ / 4) {
+            blocks_.push_back(std::make_unique<char[]>(needed));
+            reserved_ += needed;
+            used_ += needed;
+            uintptr_t base = reinterpret_cast<uintptr_t>(blocks_.back().get());
+            return reinterpret_cast<void*>((base + alignment - 1) & ~(uintptr_t(alignment) - 1));
+        }
+
+        blocks_.push_back(std::make_unique<char[]>(nextBlockSize_));
+        reserved_ += nextBlockSize_;
+        cursor_ = blocks_.back().get();
+        limit_ = cursor_ + nextBlockSize_;
+        nextBlockSize_ = std::min(nextBlockSize_ * 2, MaxBlockSize);
+        return allocate(size, alignment);
+    }
+
+} // namespace GC
@@ -0,0 +1,44 @@
+#include "../CompilationContext.h"
+
+namespace GC {
+
+    CompilationContext& CompilationContext::Global() {
+        static CompilationContext context;
+        return context;
+    }
+
+    //------------------------------------------------------------------------------
+    // One lock for both arenas: string literals and diagnostics are rare next to
+    // the tokens that need no storage at all.
+    //------------------------------------------------------------------------------
+    std::string_view CompilationContext::storeLiteral(std::string_view text) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return literals_.copy(text);
+    }
+
+    std::string_view CompilationContext::storeMessage(std::string_view text) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return messages_.copy(text);
+    }
+
+    ArenaStats CompilationContext::literalStats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return literals_.stats();
+    }
+
+    ArenaStats CompilationContext::messageStats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return messages_.stats();
+    }
+
+    void CompilationContext::addLexerStats(const LexerStats& stats) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        lexerStats_.merge(stats);
+    }
+
+    LexerStats CompilationContext::lexerStats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return lexerStats_;
+    }
+
+} // namespace GC
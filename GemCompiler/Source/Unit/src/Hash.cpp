@@ -0,0 +1,101 @@
+#include "../Hash.h"
+
+#include <cstring>
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+namespace GC {
+
+    namespace {
+
+        constexpr uint64_t Secret[4] = {
+            0xA0761D6478BD642Full, 0xE7037ED1A0B428DBull, 0x8EBC6AF09C88C6E3ull, 0x589965CC75374CC3ull,
+        };
+
+        // 64x64 -> 128-bit multiply; returns both halves.
+        inline void Multiply(uint64_t& a, uint64_t& b) noexcept {
+#ifdef _MSC_VER
+            a = _umul128(a, b, &b);
+#else
+            unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+            a = static_cast<uint64_t>(product);
+            b = static_cast<uint64_t>(product >> 64);
+#endif
+        }
+
+        inline uint64_t Mix(uint64_t a, uint64_t b) noexcept {
+            Multiply(a, b);
+            return a ^ b;
+        }
+
+        inline uint64_t Read64(const unsigned char* p) noexcept {
+            uint64_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        inline uint64_t Read32(const unsigned char* p) noexcept {
+            uint32_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        // 1 to 3 bytes: first, middle and last byte.
+        inline uint64_t Read3(const unsigned char* p, size_t size) noexcept {
+            return (uint64_t(p[0]) << 16) | (uint64_t(p[size >> 1]) << 8) | p[size - 1];
+        }
+
+    } // namespace
+
+    uint64_t Hash64(const void* data, size_t size, uint64_t seed) noexcept {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        seed ^= Mix(seed ^ Secret[0], Secret[1]);
+        uint64_t a;
+        uint64_t b;
+        if (size <= 16) {
+            if (size >= 4) {
+                // Two overlapping pairs of 4-byte reads cover every byte.
+                size_t step = (size >> 3) << 2;
+                a = (Read32(p) << 32) | Read32(p + step);
+                b = (Read32(p + size - 4) << 32) | Read32(p + size - 4 - step);
+            }
+            else if (size > 0) {
+                a = Read3(p, size);
+                b = 0;
+            }
+            else {
+                a = b = 0;
+            }
+        }
+        else {
+            size_t remaining = size;
+            if (remaining > 48) {
+                uint64_t lane1 = seed;
+                uint64_t lane2 = seed;
+                do {
+                    seed = Mix(Read64(p) ^ Secret[1], Read64(p + 8) ^ seed);
+                    lane1 = Mix(Read64(p + 16) ^ Secret[2], Read64(p + 24) ^ lane1);
+                    lane2 = Mix(Read64(p + 32) ^ Secret[3], Read64(p + 40) ^ lane2);
+                    p += 48;
+                    remaining -= 48;
+                } while (remaining > 48);
+                seed ^= lane1 ^ lane2;
+            }
+            while (remaining > 16) {
+                seed = Mix(Read64(p) ^ Secret[1], Read64(p + 8) ^ seed);
+                p += 16;
+                remaining -= 16;
+            }
+            // The last 16 bytes, overlapping what was already mixed.
+            a = Read64(p + remaining - 16);
+            b = Read64(p + remaining - 8);
+        }
+        a ^= Secret[1];
+        b ^= seed;
+        Multiply(a, b);
+        return Mix(a ^ Secret[0] ^ size, b ^ Secret[1]);
+    }
+
+} // namespace GC
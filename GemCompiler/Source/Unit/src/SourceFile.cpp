@@ -0,0 +1,170 @@
+#include "../SourceFile.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#ifdef WINDOWS
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace GC {
+
+    namespace {
+
+        //------------------------------------------------------------------------------
+        // Buffered fallback: read a stream to its end.
+        //------------------------------------------------------------------------------
+        bool ReadAll(std::FILE* stream, std::vector<char>& buffer) {
+            char chunk[64 * 1024];
+            size_t count;
+            while ((count = std::fread(chunk, 1, sizeof(chunk), stream)) > 0)
+                buffer.insert(buffer.end(), chunk, chunk + count);
+            return !std::ferror(stream);
+        }
+
+        bool ReadPath(const std::string& path, std::vector<char>& buffer, std::string& error) {
+            if (path == "-") {
+                if (!ReadAll(stdin, buffer)) {
+                    error = "could not read from stdin";
+                    return false;
+                }
+                return true;
+            }
+            std::FILE* stream = std::fopen(path.c_str(), "rb");
+            if (!stream) {
+                error = std::strerror(errno);
+                return false;
+            }
+            bool ok = ReadAll(stream, buffer);
+            std::fclose(stream);
+            if (!ok)
+                error = "read error";
+            return ok;
+        }
+
+        //------------------------------------------------------------------------------
+        // Memory mapping. Returns nullptr when the input cannot be mapped (not a
+        // regular file, empty, or the platform refused), in which case the caller
+        // falls back to reading.
+        //------------------------------------------------------------------------------
+#ifdef WINDOWS
+        void* MapPath(const std::string& path, size_t& size) {
+            HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+                return nullptr;
+
+            void* view = nullptr;
+            LARGE_INTEGER length;
+            if (GetFileType(file) == FILE_TYPE_DISK && GetFileSizeEx(file, &length) && length.QuadPart > 0) {
+                HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (mapping) {
+                    view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                    CloseHandle(mapping);   // The view keeps the mapping alive.
+                }
+                size = static_cast<size_t>(length.QuadPart);
+            }
+            CloseHandle(file);
+            return view;
+        }
+
+        void Unmap(void* view, size_t) {
+            UnmapViewOfFile(view);
+        }
+#else
+        void* MapPath(const std::string& path, size_t& size) {
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+                return nullptr;
+
+            void* view = nullptr;
+            struct stat info;
+            if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+                size = static_cast<size_t>(info.st_size);
+                view = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (view == MAP_FAILED)
+                    view = nullptr;
+                else
+                    ::madvise(view, size, MADV_SEQUENTIAL);
+            }
+            ::close(fd);    // The mapping keeps its own reference to the file.
+            return view;
+        }
+
+        void Unmap(void* view, size_t size) {
+            ::munmap(view, size);
+        }
+#endif
+
+    } // namespace
+
+    SourceFile::SourceFile(SourceFile&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr))
+        , size_(std::exchange(other.size_, 0))
+        , mapping_(std::exchange(other.mapping_, nullptr))
+        , buffer_(std::move(other.buffer_)) {}
+
+    SourceFile& SourceFile::operator=(SourceFile&& other) noexcept {
+        if (this != &other) {
+            release();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            mapping_ = std::exchange(other.mapping_, nullptr);
+            buffer_ = std::move(other.buffer_);
+        }
+        return *this;
+    }
+
+    SourceFile::~SourceFile() {
+        release();
+    }
+
+    void SourceFile::release() noexcept {
+        if (mapping_)
+            Unmap(mapping_, size_);
+        mapping_ = nullptr;
+        data_ = nullptr;
+        size_ = 0;
+        buffer_.clear();
+    }
+
+    bool SourceFile::Open(const std::string& path, SourceFile& out, std::string& error) {
+        SourceFile file;
+        if (path != "-") {
+            size_t size = 0;
+            if (void* view = MapPath(path, size)) {
+                file.mapping_ = view;
+                file.data_ = static_cast<const char*>(view);
+                file.size_ = size;
+                out = std::move(file);
+                return true;
+            }
+        }
+
+        if (!ReadPath(path, file.buffer_, error))
+            return false;
+        file.data_ = file.buffer_.data();
+        file.size_ = file.buffer_.size();
+        out = std::move(file);
+        return true;
+    }
+
+    SourceFile SourceFile::FromString(std::string_view text) {
+        SourceFile file;
+        file.buffer_.assign(text.begin(), text.end());
+        file.data_ = file.buffer_.data();
+        file.size_ = file.buffer_.size();
+        return file;
+    }
+
+} // namespace GC
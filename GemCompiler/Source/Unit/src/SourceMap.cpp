@@ -0,0 +1,38 @@
+#include "../SourceMap.h"
+
+#include <algorithm>
+
+#include "../../Token/Simd.h"
+
+namespace GC {
+
+    //------------------------------------------------------------------------------
+    // Build the line-start table with the vectorized newline kernels.
+    //------------------------------------------------------------------------------
+    const std::vector<uint32_t>& SourceMap::lineStarts() const {
+        std::call_once(built_, [this] {
+            const char* begin = source_.data();
+            const char* end = begin + source_.size();
+            lineStarts_.reserve(Simd::CountNewlines(begin, end) + 1);
+            lineStarts_.push_back(0);
+            for (const char* p = Simd::FindByte(begin, end, '\n'); p != end; p = Simd::FindByte(p + 1, end, '\n'))
+                lineStarts_.push_back(static_cast<uint32_t>(p + 1 - begin));
+        });
+        return lineStarts_;
+    }
+
+    //------------------------------------------------------------------------------
+    // Offset -> line:column (both 1-based, columns counted in bytes).
+    //------------------------------------------------------------------------------
+    TokenLocation SourceMap::locate(uint32_t offset) const {
+        const std::vector<uint32_t>& starts = lineStarts();
+        auto next = std::upper_bound(starts.begin(), starts.end(), offset);
+        size_t line = static_cast<size_t>(next - starts.begin());
+        return TokenLocation{ static_cast<int>(line), static_cast<int>(offset - starts[line - 1] + 1) };
+    }
+
+    size_t SourceMap::lineCount() const {
+        return lineStarts().size();
+    }
+
+} // namespace GC
@@ -0,0 +1,12 @@
+#pragma once
+#include <string_view>
+
+namespace GC {
+
+    // Bumped with every release, and with any change to what the lexer produces
+    // for the same source. Anything persisted by the compiler (the token cache,
+    // module interfaces) is keyed on it, so a new compiler never reads an old
+    // one's files.
+    inline constexpr std::string_view CompilerVersion = "0.1.0";
+
+} // namespace GC
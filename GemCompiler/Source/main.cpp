@@ -1,49 +1,267 @@
+#include <algorithm>
 #include <iostream>
+#include <iomanip>
 #include <fstream>
 #include <string>
+#include <optional>
+#include <cstdlib>
 
 #include "Token/Token.h"
+#include "Token/TokenCache.h"
 #include "Assembler/Assembly.h"
+#include "Assembler/Elf.h"
+#include "Module/ModuleInterface.h"
+#include "Parse/Parser.h"
+#include "Unit/CompilationContext.h"
+#include "Unit/CompilationUnit.h"
+#include "Unit/SourceFile.h"
+#include "Unit/Diagnostic.h"
+#include "Thread/ThreadPool.h"
 
-int main(int argc, char* argv[]) {
-    // Check if the user has provided exactly one argument (the file path)
-    /*if (argc != 2) {
-        std::cerr << "Usage: GemCompiler <path to file>\nPlease provide the path to the file." << std::endl;
-        return EXIT_FAILURE;
-    }*/
+//------------------------------------------------------------------------------
+// --stats: arena high-water marks and lexer counters, on stderr so the assembly
+// output stays clean. --stats=json prints the same numbers as one JSON object.
+//------------------------------------------------------------------------------
+enum class StatsFormat {
+    None,
+    Table,
+    Json
+};
+
+static void PrintStatsTable(const GC::CompilationContext& context) {
+    const auto arena = [](const char* name, const GC::ArenaStats& stats) {
+        std::cerr << std::left << std::setw(14) << name << std::right
+            << std::setw(14) << stats.used << std::setw(14) << stats.reserved
+            << std::setw(8) << stats.blocks << "\n";
+    };
+    std::cerr << std::left << std::setw(14) << "arena" << std::right
+        << std::setw(14) << "used bytes" << std::setw(14) << "reserved" << std::setw(8) << "blocks" << "\n";
+    arena("literals", context.literalStats());
+    arena("symbols", context.symbolStats());
+    arena("diagnostics", context.messageStats());
+
+    if constexpr (!GC::LexerStatsEnabled) {
+        std::cerr << "\nlexer counters: not compiled in (build with LEXER_STATS)\n";
+        return;
+    }
+    const GC::LexerStats lexer = context.lexerStats();
+    const auto row = [](const std::string& name, auto value) {
+        std::cerr << std::left << std::setw(22) << name << std::right << std::setw(14) << value << "\n";
+    };
+    std::cerr << "\nlexer\n" << std::fixed << std::setprecision(3);
+    row("bytes scanned", lexer.bytesScanned());
+    row("token bytes", lexer.tokenBytes);
+    row("literal bytes", lexer.literalBytes);
+    row("trivia bytes", lexer.triviaBytes);
+    row("comment bytes", lexer.commentBytes);
+    row("tokens", lexer.tokenCount());
+    row("trivia ms (est.)", lexer.triviaNanos() / 1e6);
+    row("scan ms (est.)", lexer.scanNanos() / 1e6);
+    std::cerr << "\ntokens by type\n";
+    for (size_t type = 0; type < GC::TokenTypeCount; type++) {
+        if (lexer.tokens[type])
+            row(std::string(GC::TokenTypeName(static_cast<GC::TokenType>(type))), lexer.tokens[type]);
+    }
+}
 
-    // Open the file
-    //std::ifstream file(argv[1], std::ios::in);
-    std::ifstream file("GemFiles/base.gem", std::ios::in);
+static std::string JsonString(std::string_view text) {
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\')
+            quoted += '\\';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+static void PrintStatsJson(const GC::CompilationContext& context) {
+    const auto arena = [](const GC::ArenaStats& stats) {
+        return "{\"used\":" + std::to_string(stats.used) + ",\"reserved\":" + std::to_string(stats.reserved)
+            + ",\"blocks\":" + std::to_string(stats.blocks) + "}";
+    };
+    std::cerr << "{\"arenas\":{\"literals\":" << arena(context.literalStats())
+        << ",\"symbols\":" << arena(context.symbolStats())
+        << ",\"diagnostics\":" << arena(context.messageStats()) << "}";
+
+    if constexpr (GC::LexerStatsEnabled) {
+        const GC::LexerStats lexer = context.lexerStats();
+        std::cerr << std::fixed << std::setprecision(3)
+            << ",\"lexer\":{\"bytesScanned\":" << lexer.bytesScanned()
+            << ",\"tokenBytes\":" << lexer.tokenBytes
+            << ",\"literalBytes\":" << lexer.literalBytes
+            << ",\"triviaBytes\":" << lexer.triviaBytes
+            << ",\"commentBytes\":" << lexer.commentBytes
+            << ",\"tokens\":" << lexer.tokenCount()
+            << ",\"triviaMs\":" << lexer.triviaNanos() / 1e6
+            << ",\"scanMs\":" << lexer.scanNanos() / 1e6
+            << ",\"tokensByType\":{";
+        const char* separator = "";
+        for (size_t type = 0; type < GC::TokenTypeCount; type++) {
+            if (lexer.tokens[type]) {
+                std::cerr << separator << JsonString(GC::TokenTypeName(static_cast<GC::TokenType>(type))) << ":" << lexer.tokens[type];
+                separator = ",";
+            }
+        }
+        std::cerr << "}}";
+    }
+    std::cerr << "}" << std::endl;
+}
 
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not open file '" << argv[1] << "'." << std::endl;
+int main(int argc, char* argv[]) {
+    // Usage: GemCompiler [--jobs N] [--token-cache DIR] [--echo-source] [--dump-ast] [--stats[=json]]
+    //                   [--emit-asm] [--emit-obj] [-o output] [path to file | -]
+    const char* usage = "Usage: GemCompiler [--jobs N] [--token-cache DIR] [--echo-source] [--dump-ast] [--stats[=json]]\n"
+                        "                   [--emit-asm] [--emit-obj] [-o output] [path to file | -]";
+    std::string path = "GemFiles/base.gem";
+    std::string cacheDirectory;
+    std::string outputPath;
+    bool emitAsm = false;
+    bool emitObject = false;
+    size_t jobs = 1;
+    bool echoSource = false;
+    bool dumpAst = false;
+    StatsFormat stats = StatsFormat::None;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--jobs" && i + 1 < argc) {
+            jobs = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--token-cache" && i + 1 < argc) {
+            cacheDirectory = argv[++i];
+        }
+        else if (arg == "-o" && i + 1 < argc) {
+            outputPath = argv[++i];
+        }
+        else if (arg == "--emit-asm") {
+            emitAsm = true;
+        }
+        else if (arg == "--emit-obj") {
+            emitObject = true;
+        }
+        else if (arg == "--echo-source") {
+            echoSource = true;
+        }
+        else if (arg == "--dump-ast") {
+            dumpAst = true;
+        }
+        else if (arg == "--stats") {
+            stats = StatsFormat::Table;
+        }
+        else if (arg == "--stats=json") {
+            stats = StatsFormat::Json;
+        }
+        else if (arg.rfind("-", 0) == 0 && arg != "-") {
+            std::cerr << usage << std::endl;
+            return EXIT_FAILURE;
+        }
+        else {
+            path = arg;
+        }
+    }
+
+    // Map the file (or read stdin / a pipe) without copying it.
+    GC::SourceFile file;
+    std::string error;
+    if (!GC::SourceFile::Open(path, file, error)) {
+        std::cerr << "Error: Could not open file '" << path << "': " << error << std::endl;
         return EXIT_FAILURE;
     }
 
-    // Read the file content
-    std::stringstream contents_stream;
-    contents_stream << file.rdbuf();
-    std::string content = contents_stream.str();
+    // The unit owns the source bytes the tokens point into and the context owns
+    // their names, strings and diagnostics, so both must outlive them.
+    GC::CompilationUnit unit(path, std::move(file));
+    GC::CompilationContext& context = GC::CompilationContext::Global();
+
+    // Debug aid: echo the file content.
+    if (echoSource)
+        std::cout << "File content:\n" << unit.getSource() << "\n\n";
+
+#ifdef WINDOWS
+    // No PE/COFF writer yet: Windows builds still go through nasm and a C toolchain.
+    const GC::Target target = GC::Target::Win64;
+    emitAsm = true;
+#else
+    // Linux: an ELF executable by default, or an object for the system linker.
+    const GC::Target target = emitObject ? GC::Target::LinuxLibc : GC::Target::LinuxStatic;
+#endif
 
-    // Close the file
-    file.close();
+    // --jobs lexes in parallel chunks and parses top-level declarations in
+    // parallel (0 = one job per hardware thread).
+    std::optional<GC::ThreadPool> pool;
+    if (jobs != 1)
+        pool.emplace(jobs);
 
-    // Output the file content
-    std::cout << "File content:\n" << content << "\n\n";
+    // Reuse the tokens of an unchanged file from the cache, or lex them and cache them.
+    GC::TokenCache cache(cacheDirectory);
+    GC::TokenStream tokens;
+    if (!cache.load(unit.getSource(), tokens, context)) {
+        tokens = pool ? GC::Tokenize(unit, *pool) : GC::Tokenize(unit);
+        cache.store(unit.getSource(), tokens, context);
+    }
 
-    auto tk_len = GC::Tokenize(content);
+    GC::Ast ast = pool ? GC::Parse(tokens, *pool, context) : GC::Parse(tokens, context);
+    if (dumpAst)
+        std::cout << GC::FormatAst(ast, tokens);
+    GC::Program program = GC::GenerateProgram(ast, tokens, target);
 
-    std::cout << "\n\n" << GC::TokenToASM(tk_len);
+    // Lexer and parser diagnostics, in source order.
+    std::vector<GC::Diagnostic> diagnostics = tokens.diagnostics();
+    diagnostics.insert(diagnostics.end(), ast.diagnostics().begin(), ast.diagnostics().end());
+    std::stable_sort(diagnostics.begin(), diagnostics.end(),
+        [](const GC::Diagnostic& a, const GC::Diagnostic& b) { return a.offset < b.offset; });
 
-    {
+    for (const GC::Diagnostic& diagnostic : diagnostics)
+        std::cerr << GC::FormatDiagnostic(unit, diagnostic) << std::endl;
+    if (stats == StatsFormat::Table)
+        PrintStatsTable(context);
+    else if (stats == StatsFormat::Json)
+        PrintStatsJson(context);
+    if (!diagnostics.empty())
+        return EXIT_FAILURE;
 
-		std::fstream file("outAsm/out.asm", std::ios::out);
-		file << GC::TokenToASM(tk_len);
+    // Imported files are resolved eagerly: their interfaces are mapped from the
+    // .gemi next to each source, and rebuilt first when it or anything it imports
+    // changed, so a missing or broken module fails the compile here. Code
+    // generation does not read them yet, so each view is dropped once checked.
+    for (GC::NodeId item : ast.list(ast[ast.root()].lhs)) {
+        if (ast[item].kind != GC::NodeKind::Import || tokens.kind(ast[item].token) != GC::TokenType::StringLiteral)
+            continue;
+        const std::string modulePath = GC::ResolveImport(path, tokens.getLiteral<std::string_view>(ast[item].token).value_or(""));
+        GC::ModuleInterface module;
+        if (!GC::ImportModule(modulePath, path, module, error, context)) {
+            std::cerr << "Error: " << error << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
 
+    if (emitAsm) {
+        // Debug listing of exactly what is encoded below.
+        std::string outputASM = GC::FormatNasm(program);
+        std::cout << "\n\n" << outputASM;
+        std::fstream file("outAsm/out.asm", std::ios::out);
+        file << outputASM;
     }
 
+#ifdef WINDOWS
     system("set PATH=%PATH%;../Setup/Vendor/MinGW/bin && set PATH=%PATH%;../Setup/Vendor/Binaries/Nasm && cd outASM/ && nasm -f win64 out.asm -o out.obj && gcc2 out.obj -o out.exe");
+#else
+    // Encode in process and write the ELF file directly.
+    GC::MachineCode code = GC::Encode(program);
+    std::vector<uint8_t> image;
+    if (emitObject) {
+        image = GC::ElfObject(program, code);
+    }
+    else if (!GC::ElfExecutable(program, code, image, error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (outputPath.empty())
+        outputPath = emitObject ? "outAsm/out.o" : "outAsm/out";
+    if (!GC::WriteBinary(outputPath, image, !emitObject, error)) {
+        std::cerr << "Error: Could not write '" << outputPath << "': " << error << std::endl;
+        return EXIT_FAILURE;
+    }
+#endif
 
     return 0;
-}
\ No newline at end of file
+}
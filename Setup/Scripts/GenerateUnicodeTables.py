@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+"""Generates GemCompiler/Source/Token/UnicodeTables.h.
+
+The identifier tables follow XID_Start / XID_Continue of the Unicode version
+bundled with the running Python (str.isidentifier() is defined by the same
+properties). Re-run after a Python upgrade to pick up a newer Unicode version:
+
+    python3 Setup/Scripts/GenerateUnicodeTables.py
+"""
+
+import os
+import sys
+import unicodedata
+
+MAX_CODE_POINT = 0x10FFFF
+BLOCK_BITS = 8
+BLOCK_SIZE = 1 << BLOCK_BITS
+WORDS = BLOCK_SIZE // 64
+
+OUTPUT = os.path.join(os.path.dirname(__file__), "..", "..", "GemCompiler", "Source", "Token", "UnicodeTables.h")
+
+
+def is_xid_start(cp):
+    c = chr(cp)
+    return c != "_" and c.isidentifier()
+
+
+def is_xid_continue(cp):
+    return ("a" + chr(cp)).isidentifier()
+
+
+def bitset(block, predicate):
+    words = [0] * WORDS
+    for i in range(BLOCK_SIZE):
+        if predicate(block * BLOCK_SIZE + i):
+            words[i // 64] |= 1 << (i % 64)
+    return words
+
+
+def main():
+    blocks = []
+    index = []
+    unique = {}
+    for block in range((MAX_CODE_POINT + 1) // BLOCK_SIZE):
+        words = tuple(bitset(block, is_xid_start) + bitset(block, is_xid_continue))
+        if words not in unique:
+            unique[words] = len(blocks)
+            blocks.append(words)
+        index.append(unique[words])
+    if len(blocks) > 256:
+        sys.exit("too many distinct blocks for a uint8_t index")
+
+    out = []
+    out.append("#pragma once")
+    out.append("#include <cstdint>")
+    out.append("")
+    out.append("// Generated by Setup/Scripts/GenerateUnicodeTables.py from Unicode %s. Do not edit." % unicodedata.unidata_version)
+    out.append("")
+    out.append("namespace GC::Unicode {")
+    out.append("")
+    out.append("    // Two-level XID_Start / XID_Continue table: XidIndex maps the high bits of a")
+    out.append("    // code point (cp >> %d) to one of the distinct %d-code-point blocks, and each" % (BLOCK_BITS, BLOCK_SIZE))
+    out.append("    // block holds a XID_Start bitset followed by a XID_Continue bitset.")
+    out.append("    inline constexpr uint32_t XidBlockBits = %d;" % BLOCK_BITS)
+    out.append("    inline constexpr uint32_t XidWordsPerSet = %d;" % WORDS)
+    out.append("")
+    out.append("    inline constexpr uint8_t XidIndex[%d] = {" % len(index))
+    for i in range(0, len(index), 32):
+        out.append("        " + ", ".join(str(v) for v in index[i:i + 32]) + ",")
+    out.append("    };")
+    out.append("")
+    out.append("    inline constexpr uint64_t XidBlocks[%d][%d] = {" % (len(blocks), 2 * WORDS))
+    for words in blocks:
+        out.append("        { " + ", ".join("0x%016X" % w for w in words) + " },")
+    out.append("    };")
+    out.append("")
+    out.append("} // namespace GC::Unicode")
+    out.append("")
+
+    with open(OUTPUT, "w", newline="\n") as f:
+        f.write("\n".join(out))
+    print("wrote %s: %d blocks, Unicode %s" % (os.path.normpath(OUTPUT), len(blocks), unicodedata.unidata_version))
+
+
+if __name__ == "__main__":
+    main()